@@ -0,0 +1 @@
+g++ -o HeaderBenchmark HeaderBenchmark.cpp -std=c++17 -O2 $(rivet-config --cppflags --ldflags --libs) -lHepMC3 -Wno-switch -Wno-unused-function -Wno-deprecated-declarations && ./HeaderBenchmark "$@"    #Same warning flags as Rivet/CompileAndRun.sh
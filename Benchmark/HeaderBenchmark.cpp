@@ -0,0 +1,332 @@
+#include <Rivet/Particle.hh>
+#include <Rivet/Jet.hh>
+#include <HepMC3/GenEvent.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include "SyntheticEvents.hpp"
+#include "../Headers/DarknessRivet.hpp"
+#include "../Headers/Decay.hpp"
+#include "../Headers/ParticleName.hpp"
+#include "../Headers/ParticleSortRivet.hpp"
+#include "../Headers/ParticleHandle.hpp"
+#include "../Headers/ContentHash.hpp"
+
+//An event prepared the same way as in the analyses: the final state and the jets are built before the timing starts, so only the functions in Headers/ are timed
+struct BenchmarkEvent{
+    HepMC3::GenEvent genEvent;
+    Rivet::Particles finalState;
+    Rivet::Jets jets;
+    //The same final state as flat arrays, for the benchmarks of the templated functions
+    FlatEventStorage flatEvent;
+    std::vector<FlatParticle> flatFinalState;
+};
+
+//Simple seeded cone jets with R = 0.4 around the hardest remaining particles, including invisible particles like the analyses do. The jets only need to look like the jets in the analyses, they don't need to be infrared safe.
+static Rivet::Jets coneJets(Rivet::Particles particles, double radius = 0.4, double minPT = 20.0){
+    std::sort(particles.begin(), particles.end(), [](const Rivet::Particle &a, const Rivet::Particle &b){
+        return a.pT() > b.pT();
+    });
+    Rivet::Jets jets;
+    std::vector<bool> used(particles.size(), false);
+    for(std::size_t seed = 0; seed < particles.size(); seed++){
+        if(used[seed]){
+            continue;
+        }
+        Rivet::Particles constituents;
+        Rivet::FourMomentum momentum;
+        for(std::size_t i = seed; i < particles.size(); i++){
+            if(!used[i] && Rivet::deltaR(particles[seed], particles[i]) < radius){
+                used[i] = true;
+                constituents.push_back(particles[i]);
+                momentum += particles[i].momentum();
+            }
+        }
+        if(momentum.pT() >= minPT){
+            jets.push_back(Rivet::Jet(constituents, momentum));
+        }
+    }
+    return jets;
+}
+
+struct BenchmarkResult{
+    std::string model;
+    std::string benchmark;
+    long calls;
+    double seconds;
+    int events;
+    unsigned long seed;
+    std::string checksum;
+
+    double nanosecondsPerCall() const{
+        return this->calls > 0 ? 1e9 * this->seconds / this->calls : 0.0;
+    }
+    double eventsPerSecond() const{
+        return this->seconds > 0 ? this->events / this->seconds : 0.0;
+    }
+};
+
+//A benchmark runs a function over all events, adding its results to the checksum, and returns the number of calls
+typedef std::function<long(const BenchmarkEvent&, ContentHash&)> Benchmark;
+
+static std::vector<std::pair<std::string, Benchmark>> benchmarks(){
+    return {
+        {"hasDarkAncestor", [](const BenchmarkEvent &event, ContentHash &checksum){
+            for(const Rivet::Particle &particle: event.finalState){
+                checksum.add(static_cast<int>(hasDarkAncestor(particle)));
+            }
+            return static_cast<long>(event.finalState.size());
+        }},
+        {"pTDarkness", [](const BenchmarkEvent &event, ContentHash &checksum){
+            for(const Rivet::Jet &jet: event.jets){
+                checksum.add(pTDarkness(jet));
+            }
+            return static_cast<long>(event.jets.size());
+        }},
+        {"multiplicityDarkness", [](const BenchmarkEvent &event, ContentHash &checksum){
+            for(const Rivet::Jet &jet: event.jets){
+                checksum.add(multiplicityDarkness(jet));
+            }
+            return static_cast<long>(event.jets.size());
+        }},
+        {"Decay::fromChild", [](const BenchmarkEvent &event, ContentHash &checksum){
+            for(const Rivet::Particle &particle: event.finalState){
+                const Decay decay = Decay::fromChild(particle);
+                for(Rivet::PdgId pdgid: decay.parents()){
+                    checksum.add(pdgid);
+                }
+                checksum.add(0);
+                for(Rivet::PdgId pdgid: decay.children()){
+                    checksum.add(pdgid);
+                }
+            }
+            return static_cast<long>(event.finalState.size());
+        }},
+        //Should give the same checksums as hasDarkAncestor and Decay::fromChild
+        {"hasDarkAncestor/FlatEvent", [](const BenchmarkEvent &event, ContentHash &checksum){
+            for(const FlatParticle &particle: event.flatFinalState){
+                checksum.add(static_cast<int>(hasDarkAncestor(particle)));
+            }
+            return static_cast<long>(event.flatFinalState.size());
+        }},
+        {"Decay::fromChild/FlatEvent", [](const BenchmarkEvent &event, ContentHash &checksum){
+            for(const FlatParticle &particle: event.flatFinalState){
+                const Decay decay = Decay::fromChild(particle);
+                for(Rivet::PdgId pdgid: decay.parents()){
+                    checksum.add(pdgid);
+                }
+                checksum.add(0);
+                for(Rivet::PdgId pdgid: decay.children()){
+                    checksum.add(pdgid);
+                }
+            }
+            return static_cast<long>(event.flatFinalState.size());
+        }},
+        {"particleNameAsTLatex", [](const BenchmarkEvent &event, ContentHash &checksum){
+            for(const Rivet::Particle &particle: event.finalState){
+                checksum.add(particleNameAsTLatex(particle.pid()));
+            }
+            return static_cast<long>(event.finalState.size());
+        }},
+        {"particlesByEnergy", [](const BenchmarkEvent &event, ContentHash &checksum){
+            //Called on the parents of each particle like in hasDarkAncestor, and once on the whole final state
+            long calls = 1;
+            for(const Rivet::Particle &particle: event.finalState){
+                const Rivet::Particles parents = particle.parents();
+                if(parents.size() > 0){
+                    checksum.add(particlesByEnergy(parents)[0].pid());
+                    calls++;
+                }
+            }
+            for(const Rivet::Particle &particle: particlesByEnergy(event.finalState)){
+                checksum.add(particle.energy());
+            }
+            return calls;
+        }},
+        //Everything an analysis does with the headers for one event: darkness, invisibility and lepton fraction of each jet, and the decay and name of each final state particle
+        {"event", [](const BenchmarkEvent &event, ContentHash &checksum){
+            for(const Rivet::Jet &jet: event.jets){
+                checksum.add(pTDarkness(jet));
+                checksum.add(multiplicityDarkness(jet));
+                checksum.add(pTInvisibility(jet));
+                checksum.add(pTLeptonFraction(jet));
+            }
+            for(const Rivet::Particle &particle: event.finalState){
+                const Decay decay = Decay::fromChild(particle);
+                checksum.add(static_cast<int>(decay.parents().size()));
+                checksum.add(particleNameAsTLatex(particle.pid()));
+            }
+            return 1l;
+        }}
+    };
+}
+
+//Runs benchmark over all events repetitions times and keeps the fastest run, which is the one least disturbed by other processes
+static BenchmarkResult runBenchmark(const std::string &model, const std::string &name, const Benchmark &benchmark, const std::vector<BenchmarkEvent> &events, unsigned long seed, int repetitions){
+    BenchmarkResult result{model, name, 0, 0.0, static_cast<int>(events.size()), seed, ""};
+    for(int repetition = 0; repetition < repetitions; repetition++){
+        ContentHash checksum;
+        long calls = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for(const BenchmarkEvent &event: events){
+            calls += benchmark(event, checksum);
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if(repetition == 0 || seconds < result.seconds){
+            result.seconds = seconds;
+        }
+        if(repetition > 0 && checksum.hex() != result.checksum){
+            std::cerr << "Warning: " << name << " gave different results in different repetitions for model " << model << "." << std::endl;
+        }
+        result.calls = calls;
+        result.checksum = checksum.hex();
+    }
+    return result;
+}
+
+static std::map<std::pair<std::string, std::string>, BenchmarkResult> readResults(const std::string &path){
+    std::map<std::pair<std::string, std::string>, BenchmarkResult> results;
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);    //Header
+    while(std::getline(file, line)){
+        std::istringstream stream(line);
+        BenchmarkResult result;
+        double nanosecondsPerCall, eventsPerSecond;
+        std::getline(stream, result.model, '\t');
+        std::getline(stream, result.benchmark, '\t');
+        stream >> result.events >> result.seed >> result.calls >> nanosecondsPerCall >> eventsPerSecond >> result.checksum;
+        result.seconds = eventsPerSecond > 0 ? result.events / eventsPerSecond : 0.0;
+        results[{result.model, result.benchmark}] = result;
+    }
+    return results;
+}
+
+int main(int argc, char **argv){
+    std::vector<std::string> models;
+    std::vector<std::string> selectedBenchmarks;
+    int numberOfEvents = 200, repetitions = 5;
+    unsigned long seed = 1;
+    std::string outfile = "BenchmarkResults.tsv", reference;
+
+    for(int argi = 1; argi < argc; argi++){
+        const std::string arg = argv[argi];
+        if(arg == "-m" || arg == "--model"){
+            models.push_back(argv[++argi]);
+        }
+        else if(arg == "-b" || arg == "--benchmark"){
+            selectedBenchmarks.push_back(argv[++argi]);
+        }
+        else if(arg == "-n" || arg == "--events"){
+            numberOfEvents = std::max(1, std::atoi(argv[++argi]));
+        }
+        else if(arg == "-r" || arg == "--repetitions"){
+            repetitions = std::max(1, std::atoi(argv[++argi]));
+        }
+        else if(arg == "-s" || arg == "--seed"){
+            seed = std::strtoul(argv[++argi], nullptr, 10);
+        }
+        else if(arg == "-o" || arg == "--output"){
+            outfile = argv[++argi];
+        }
+        else if(arg == "-c" || arg == "--compare"){
+            reference = argv[++argi];
+        }
+        else if(arg == "-h" || arg == "--help"){
+            std::cout << "Usage: HeaderBenchmark [options]" << std::endl
+                << "Options:" << std::endl
+                << "  -h, --help:             Show this help text and exit" << std::endl
+                << "  -m, --model <name>:     Benchmark the given synthetic model (A, B, C, D, E, svj-l or svj-s), can be given several times, defaults to all models" << std::endl
+                << "  -b, --benchmark <name>: Only run the given benchmark, can be given several times, defaults to all benchmarks" << std::endl
+                << "  -n, --events <n>:       Number of events to generate per model, defaults to 200" << std::endl
+                << "  -r, --repetitions <n>:  Number of times to run each benchmark, the fastest run is kept, defaults to 5" << std::endl
+                << "  -s, --seed <n>:         Random seed of the event generator, defaults to 1" << std::endl
+                << "  -o, --output <path>:    Specifies which file the table of results should be written to, defaults to BenchmarkResults.tsv" << std::endl
+                << "  -c, --compare <path>:   Compare the speed and the results with an earlier table of results" << std::endl;
+            return 0;
+        }
+        else{
+            std::cerr << "Cannot interpret argument: " << argv[argi] << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if(models.empty()){
+        for(const SyntheticModel &model: syntheticModels()){
+            models.push_back(model.name);
+        }
+    }
+
+    std::vector<BenchmarkResult> results;
+    for(const std::string &modelName: models){
+        SyntheticModel model;
+        try{
+            model = syntheticModel(modelName);
+        }
+        catch(const std::invalid_argument &error){
+            std::cerr << error.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        SyntheticEventGenerator generator(model, seed);
+        std::vector<BenchmarkEvent> events(numberOfEvents);
+        long finalStateParticles = 0, jets = 0;
+        for(BenchmarkEvent &event: events){
+            generator.generate(event.genEvent);
+            for(HepMC3::ConstGenParticlePtr particle: event.genEvent.particles()){
+                if(particle->status() == 1){
+                    event.finalState.push_back(Rivet::Particle(particle));
+                }
+            }
+            event.jets = coneJets(event.finalState);
+            event.flatEvent.fill(event.genEvent);
+            event.flatFinalState = event.flatEvent.particlesWithStatus(1);
+            finalStateParticles += event.finalState.size();
+            jets += event.jets.size();
+        }
+        std::cout << "Model " << model.name << ": " << 1.0 * finalStateParticles / numberOfEvents << " final state particles and " << 1.0 * jets / numberOfEvents << " jets per event" << std::endl;
+
+        for(const std::pair<std::string, Benchmark> &benchmark: benchmarks()){
+            if(selectedBenchmarks.empty() || std::find(selectedBenchmarks.begin(), selectedBenchmarks.end(), benchmark.first) != selectedBenchmarks.end()){
+                results.push_back(runBenchmark(model.name, benchmark.first, benchmark.second, events, seed, repetitions));
+            }
+        }
+    }
+
+    std::ofstream file(outfile);
+    file << "model\tbenchmark\tevents\tseed\tcalls\tns/call\tevents/s\tchecksum" << std::endl;
+    for(const BenchmarkResult &result: results){
+        file << result.model << "\t" << result.benchmark << "\t" << result.events << "\t" << result.seed << "\t" << result.calls << "\t" << result.nanosecondsPerCall() << "\t" << result.eventsPerSecond() << "\t" << result.checksum << std::endl;
+    }
+
+    //Print the table, with the speedup compared to the reference if one was given
+    const std::map<std::pair<std::string, std::string>, BenchmarkResult> referenceResults = reference == "" ? std::map<std::pair<std::string, std::string>, BenchmarkResult>() : readResults(reference);
+    bool identical = true;
+    std::cout << std::left << std::setw(8) << "Model" << std::setw(28) << "Benchmark" << std::right << std::setw(14) << "ns/call" << std::setw(14) << "events/s" << (reference == "" ? "" : "       speedup  results") << std::endl;
+    for(const BenchmarkResult &result: results){
+        std::cout << std::left << std::setw(8) << result.model << std::setw(28) << result.benchmark << std::right << std::fixed << std::setprecision(1) << std::setw(14) << result.nanosecondsPerCall() << std::setw(14) << result.eventsPerSecond();
+        const auto it = referenceResults.find({result.model, result.benchmark});
+        if(it != referenceResults.end()){
+            const bool same = it->second.checksum == result.checksum && it->second.events == result.events && it->second.seed == result.seed;
+            identical = identical && same;
+            std::cout << std::setw(13) << std::setprecision(2) << result.eventsPerSecond() / it->second.eventsPerSecond() << "x  " << (same ? "identical" : "DIFFERENT");
+        }
+        else if(reference != ""){
+            std::cout << std::setw(14) << "-" << "  not in reference";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "Results written to " << outfile << std::endl;
+    if(!identical){
+        std::cerr << "Some benchmarks gave different results than the reference (with the same number of events and seed, the results should be identical)." << std::endl;
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
\ No newline at end of file
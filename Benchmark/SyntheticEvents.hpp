@@ -0,0 +1,260 @@
+#pragma once
+
+#include <HepMC3/GenEvent.h>
+#include <HepMC3/GenParticle.h>
+#include <HepMC3/GenVertex.h>
+#include <HepMC3/FourVector.h>
+#include <string>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+//Parameters of the synthetic dark shower. These are not a physics simulation, they only mimic the structure of the event records of the models in Example models (genealogy depth, multiplicity, dark/SM mix), which is what determines the cost of the functions in Headers/
+struct SyntheticModel{
+    std::string name;
+    double mediatorMass;         //Z' mass in GeV
+    double darkHadronMass;       //Mass of the dark pions in GeV
+    double rhoFraction;          //Fraction of dark hadrons that are dark rho mesons decaying to two dark pions (HiddenValley:probVector)
+    double invisibleFraction;    //Fraction of dark pions that are stable and invisible (r_inv)
+    int darkPionDecay;           //PDG ID of what visible dark pions decay to in pairs: a SM quark or 4900022 for dark photons
+    double darkPhotonLeptonFraction;    //Fraction of dark photons that decay to leptons instead of pions
+    int showerDepth;             //Number of emissions per dark quark in the dark shower (roughly log(mediator mass / dark confinement scale))
+    int recoilCopies;            //Number of copies of each shower parton, like the recoil copies in a Pythia event record
+    int hadronsPerParton;        //Average number of dark hadrons per dark shower parton
+    int smHadronsPerQuark;       //Average number of SM hadrons per SM quark from a dark pion decay
+    int underlyingEvent;         //Average number of SM hadrons from initial state radiation and the underlying event
+};
+
+inline std::vector<SyntheticModel> syntheticModels(){
+    return {
+        //name, mZ', m(pi_D), probVector, r_inv, pi_D decay, lepton fraction, shower depth, copies, hadrons/parton, SM hadrons/quark, UE hadrons
+        {"A", 1500, 10.0, 0.173, 0.0, 4, 0.0, 4, 2, 3, 6, 150},
+        {"B", 1500, 2.0, 0.441, 0.0, 3, 0.0, 7, 2, 4, 3, 150},
+        {"C", 1500, 10.0, 0.173, 0.0, 4900022, 0.44, 4, 2, 3, 3, 150},
+        {"D", 1500, 2.0, 0.173, 0.0, 4900022, 0.30, 4, 2, 3, 2, 150},
+        {"E", 1500, 2.0, 0.441, 0.0, 4, 0.0, 7, 2, 4, 6, 150},
+        {"svj-l", 2000, 10.0, 0.75, 0.7, 3, 0.0, 5, 2, 3, 4, 150},
+        {"svj-s", 1500, 20.0, 0.75, 0.2, 3, 0.0, 5, 2, 3, 4, 150}
+    };
+}
+
+inline SyntheticModel syntheticModel(const std::string &name){
+    for(const SyntheticModel &model: syntheticModels()){
+        if(model.name == name){
+            return model;
+        }
+    }
+    throw std::invalid_argument("Unknown synthetic model " + name);
+}
+
+//Generates synthetic HepMC3 events with the genealogy of a dark shower: beams -> Z' -> dark quarks -> dark shower with recoil copies -> dark strings -> dark hadrons -> (invisible dark pions | SM quarks or dark photons -> SM strings -> SM hadrons -> photons), plus SM hadrons from the underlying event.
+class SyntheticEventGenerator{
+public:
+    SyntheticEventGenerator(const SyntheticModel &model, unsigned long seed = 1): _model(model), _random(seed){}
+
+    void generate(HepMC3::GenEvent &event){
+        event.clear();
+        event.set_units(HepMC3::Units::GEV, HepMC3::Units::MM);
+
+        //Beams and resonance
+        const double beamEnergy = 6500.0;
+        HepMC3::GenParticlePtr beam1 = std::make_shared<HepMC3::GenParticle>(HepMC3::FourVector(0, 0, beamEnergy, beamEnergy), 2212, 4);
+        HepMC3::GenParticlePtr beam2 = std::make_shared<HepMC3::GenParticle>(HepMC3::FourVector(0, 0, -beamEnergy, beamEnergy), 2212, 4);
+        HepMC3::GenVertexPtr hardVertex = std::make_shared<HepMC3::GenVertex>();
+        hardVertex->add_particle_in(beam1);
+        hardVertex->add_particle_in(beam2);
+        event.add_vertex(hardVertex);
+        const double resonancePz = this->gauss(0.0, 300.0);
+        HepMC3::GenParticlePtr resonance = this->addChild(hardVertex, 4900023, momentum(0.0, 0.0, resonancePz, this->_model.mediatorMass), 62);
+        resonance = this->addCopies(event, resonance, 1);
+
+        //Underlying event and initial state radiation, which is not dark
+        for(HepMC3::GenParticlePtr beam: {beam1, beam2}){
+            HepMC3::GenParticlePtr remnant = this->addChild(hardVertex, 21, fromPtEtaPhiM(this->exponential(20.0), this->gauss(0.0, 2.5), this->uniform(-M_PI, M_PI), 0.0), 63);
+            remnant = this->addCopies(event, remnant, this->_model.recoilCopies);
+            this->decaySmHadrons(event, this->hadronize(event, {remnant}, this->poisson(this->_model.underlyingEvent / 2.0) + 1, 0.3));
+        }
+
+        //Resonance decay to a dark quark pair, back to back in the rest frame of the resonance
+        const double cosTheta = this->uniform(-0.8, 0.8), phi = this->uniform(-M_PI, M_PI);
+        const double p = this->_model.mediatorMass / 2;
+        const double sinTheta = std::sqrt(1 - cosTheta * cosTheta);
+        HepMC3::GenVertexPtr resonanceDecay = std::make_shared<HepMC3::GenVertex>();
+        resonanceDecay->add_particle_in(resonance);
+        event.add_vertex(resonanceDecay);
+        for(int sign: {1, -1}){
+            const HepMC3::FourVector darkQuarkMomentum = momentum(sign * p * sinTheta * std::cos(phi), sign * p * sinTheta * std::sin(phi), sign * p * cosTheta + resonancePz / 2, 20.0);
+            HepMC3::GenParticlePtr darkQuark = this->addChild(resonanceDecay, sign * 4900101, darkQuarkMomentum, 23);
+            this->darkShower(event, darkQuark);
+        }
+    }
+
+private:
+    static HepMC3::FourVector momentum(double px, double py, double pz, double mass){
+        return HepMC3::FourVector(px, py, pz, std::sqrt(px * px + py * py + pz * pz + mass * mass));
+    }
+    static HepMC3::FourVector fromPtEtaPhiM(double pt, double eta, double phi, double mass){
+        return momentum(pt * std::cos(phi), pt * std::sin(phi), pt * std::sinh(eta), mass);
+    }
+    //A fraction z of the momentum of parent, smeared in eta and phi by sigma
+    HepMC3::FourVector split(const HepMC3::FourVector &parent, double z, double sigma, double mass){
+        const double eta = std::abs(parent.perp()) > 0 ? parent.eta() : 0.0;
+        return fromPtEtaPhiM(z * parent.perp(), eta + this->gauss(0.0, sigma), parent.phi() + this->gauss(0.0, sigma), mass);
+    }
+
+    HepMC3::GenParticlePtr addChild(HepMC3::GenVertexPtr vertex, int pid, const HepMC3::FourVector &p, int status){
+        HepMC3::GenParticlePtr child = std::make_shared<HepMC3::GenParticle>(p, pid, status);
+        child->set_generated_mass(std::sqrt(std::max(p.m2(), 0.0)));
+        vertex->add_particle_out(child);
+        return child;
+    }
+
+    //Makes a chain of copies of particle (each the only child of the previous one) and returns the last copy
+    HepMC3::GenParticlePtr addCopies(HepMC3::GenEvent &event, HepMC3::GenParticlePtr particle, int copies){
+        for(int i = 0; i < copies; i++){
+            HepMC3::GenVertexPtr vertex = std::make_shared<HepMC3::GenVertex>(particle->production_vertex() ? particle->production_vertex()->position() : HepMC3::FourVector());
+            vertex->add_particle_in(particle);
+            event.add_vertex(vertex);
+            particle = this->addChild(vertex, particle->pid(), particle->momentum(), 44);
+        }
+        return particle;
+    }
+
+    //Each emission splits off a dark gluon, and the dark quark continues as a recoil copy
+    void darkShower(HepMC3::GenEvent &event, HepMC3::GenParticlePtr darkQuark){
+        std::vector<HepMC3::GenParticlePtr> partons;
+        for(int emission = 0; emission < this->_model.showerDepth; emission++){
+            HepMC3::GenVertexPtr vertex = std::make_shared<HepMC3::GenVertex>();
+            vertex->add_particle_in(darkQuark);
+            event.add_vertex(vertex);
+            const double z = this->uniform(0.05, 0.4);
+            HepMC3::GenParticlePtr darkGluon = this->addChild(vertex, 4900021, this->split(darkQuark->momentum(), z, 0.15, 0.0), 51);
+            darkQuark = this->addChild(vertex, darkQuark->pid(), this->split(darkQuark->momentum(), 1 - z, 0.02, 20.0), 51);
+            partons.push_back(this->addCopies(event, darkGluon, this->_model.recoilCopies));
+            darkQuark = this->addCopies(event, darkQuark, this->_model.recoilCopies);
+        }
+        partons.push_back(darkQuark);
+
+        //Dark hadronization: all partons of the shower form one string, like in Pythia
+        std::vector<HepMC3::GenParticlePtr> darkHadrons = this->hadronize(event, partons, this->poisson(this->_model.hadronsPerParton * partons.size()) + 1, 0.3, true);
+        for(HepMC3::GenParticlePtr darkHadron: darkHadrons){
+            this->decayDarkHadron(event, darkHadron);
+        }
+    }
+
+    //Makes a string (PDG ID 4900092 for dark strings, 92 for SM strings) with partons as parents and n hadrons as children, returns the hadrons
+    std::vector<HepMC3::GenParticlePtr> hadronize(HepMC3::GenEvent &event, const std::vector<HepMC3::GenParticlePtr> &partons, int n, double sigma, bool dark = false){
+        HepMC3::FourVector total;
+        HepMC3::GenVertexPtr stringVertex = std::make_shared<HepMC3::GenVertex>();
+        for(HepMC3::GenParticlePtr parton: partons){
+            stringVertex->add_particle_in(parton);
+            total += parton->momentum();
+        }
+        event.add_vertex(stringVertex);
+        HepMC3::GenParticlePtr string = this->addChild(stringVertex, dark ? 4900092 : 92, total, 12);
+        HepMC3::GenVertexPtr hadronVertex = std::make_shared<HepMC3::GenVertex>();
+        hadronVertex->add_particle_in(string);
+        event.add_vertex(hadronVertex);
+
+        std::vector<HepMC3::GenParticlePtr> hadrons;
+        std::vector<double> fractions(std::max(n, 1));
+        double sum = 0.0;
+        for(double &fraction: fractions){
+            fraction = this->exponential(1.0);
+            sum += fraction;
+        }
+        for(double fraction: fractions){
+            int pid;
+            double mass;
+            if(dark){
+                const bool rho = this->uniform(0.0, 1.0) < this->_model.rhoFraction;
+                pid = rho ? 4900113 : (this->uniform(0.0, 1.0) < 0.5 ? 4900111 : 4900211);
+                mass = rho ? 2.5 * this->_model.darkHadronMass : this->_model.darkHadronMass;
+            }
+            else{
+                const double r = this->uniform(0.0, 1.0);
+                pid = r < 0.3 ? 211 : r < 0.6 ? -211 : r < 0.85 ? 111 : r < 0.9 ? 321 : r < 0.95 ? -321 : r < 0.975 ? 2212 : -2212;
+                mass = std::abs(pid) == 211 || pid == 111 ? 0.14 : std::abs(pid) == 321 ? 0.49 : 0.94;
+            }
+            hadrons.push_back(this->addChild(hadronVertex, pid, this->split(total, fraction / sum, sigma, mass), dark ? 83 : 1));
+        }
+        return hadrons;
+    }
+
+    void decayDarkHadron(HepMC3::GenEvent &event, HepMC3::GenParticlePtr darkHadron){
+        //Dark rho mesons decay to two dark pions
+        if(darkHadron->pid() == 4900113){
+            for(HepMC3::GenParticlePtr darkPion: this->decay(event, darkHadron, {4900111, 4900111}, this->_model.darkHadronMass)){
+                this->decayDarkHadron(event, darkPion);
+            }
+            return;
+        }
+        //A fraction r_inv of the dark pions are stable and invisible
+        if(this->uniform(0.0, 1.0) < this->_model.invisibleFraction){
+            darkHadron->set_pid(4900211);
+            darkHadron->set_status(1);
+            return;
+        }
+        if(this->_model.darkPionDecay == 4900022){
+            for(HepMC3::GenParticlePtr darkPhoton: this->decay(event, darkHadron, {4900022, 4900022}, 0.7)){
+                const bool leptons = this->uniform(0.0, 1.0) < this->_model.darkPhotonLeptonFraction;
+                const int pid = leptons ? (this->uniform(0.0, 1.0) < 0.5 ? 11 : 13) : 211;
+                for(HepMC3::GenParticlePtr child: this->decay(event, darkPhoton, {pid, -pid}, leptons ? 0.0 : 0.14)){
+                    child->set_status(1);
+                }
+            }
+            return;
+        }
+        const int quark = this->_model.darkPionDecay;
+        std::vector<HepMC3::GenParticlePtr> quarks = this->decay(event, darkHadron, {quark, -quark}, 0.5);
+        for(HepMC3::GenParticlePtr &smQuark: quarks){
+            smQuark = this->addCopies(event, smQuark, this->_model.recoilCopies);
+        }
+        this->decaySmHadrons(event, this->hadronize(event, quarks, this->poisson(this->_model.smHadronsPerQuark * 2.0) + 1, 0.2));
+    }
+
+    //Neutral pions decay to two photons, the other SM hadrons are stable
+    void decaySmHadrons(HepMC3::GenEvent &event, const std::vector<HepMC3::GenParticlePtr> &hadrons){
+        for(HepMC3::GenParticlePtr hadron: hadrons){
+            if(hadron->pid() == 111){
+                for(HepMC3::GenParticlePtr photon: this->decay(event, hadron, {22, 22}, 0.0)){
+                    photon->set_status(1);
+                }
+            }
+        }
+    }
+
+    //Decays particle into the given children with a displaced decay vertex, and returns the children (with status 2, the caller sets the status of stable children)
+    std::vector<HepMC3::GenParticlePtr> decay(HepMC3::GenEvent &event, HepMC3::GenParticlePtr particle, const std::vector<int> &pids, double mass){
+        particle->set_status(2);
+        const HepMC3::FourVector start = particle->production_vertex() ? particle->production_vertex()->position() : HepMC3::FourVector();
+        const double flightTime = this->exponential(1e-3) * particle->momentum().e() / std::max(particle->generated_mass(), 0.1);
+        HepMC3::GenVertexPtr vertex = std::make_shared<HepMC3::GenVertex>(HepMC3::FourVector(start.x(), start.y(), start.z(), start.t() + flightTime));
+        vertex->add_particle_in(particle);
+        event.add_vertex(vertex);
+        std::vector<HepMC3::GenParticlePtr> children;
+        const double z = this->uniform(0.2, 0.8);
+        for(std::size_t i = 0; i < pids.size(); i++){
+            children.push_back(this->addChild(vertex, pids[i], this->split(particle->momentum(), i == 0 ? z : 1 - z, 0.05, mass), 2));
+        }
+        return children;
+    }
+
+    double uniform(double min, double max){
+        return std::uniform_real_distribution<double>(min, max)(this->_random);
+    }
+    double gauss(double mean, double sigma){
+        return std::normal_distribution<double>(mean, sigma)(this->_random);
+    }
+    double exponential(double mean){
+        return std::exponential_distribution<double>(1.0 / mean)(this->_random);
+    }
+    int poisson(double mean){
+        return std::poisson_distribution<int>(mean)(this->_random);
+    }
+
+    const SyntheticModel _model;
+    std::mt19937_64 _random;
+};
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <cstdint>
+#include <cmath>
+
+//Online Poisson bootstrap: each replica counts every event a Poisson distributed number of times with mean 1, which resamples the events without keeping them. The spread of a quantity over the replicas is its statistical uncertainty, found in the same pass over the events as the quantity itself.
+//The weights of an event are a hash of its id and the replica, with no generator state carried from one event to the next, and replicas filled on different threads can be merged by adding them up.
+
+//Weights of all replicas for one event
+class BootstrapWeights{
+public:
+    BootstrapWeights(int replicas, std::uint64_t eventId): _weights(replicas){
+        //Cumulative Poisson probabilities for mean 1, the weight is the number of them that the uniform number is above
+        static const double cumulative[] = {
+            0.36787944117144233, 0.73575888234288467, 0.91969860292860584, 0.98101184312384626, 0.99634015317265634, 0.99940581518241833,
+            0.99991675885071196, 0.99998975080332531, 0.99999887479740202, 0.9999998885745216, 0.9999999899522336, 0.99999999916838922
+        };
+        const std::uint64_t seed = mix(eventId);
+        for(int i = 0; i < replicas; i++){
+            const double uniform = (mix(seed + 0x9e3779b97f4a7c15ull * (i + 1)) >> 11) * 0x1.0p-53;
+            double weight = 0.0;
+            for(const double probability: cumulative){
+                weight += uniform >= probability;
+            }
+            this->_weights[i] = weight;
+        }
+    }
+
+    int replicas() const{
+        return this->_weights.size();
+    }
+    const double* data() const{
+        return this->_weights.data();
+    }
+
+private:
+    //The finalizer of SplitMix64, which turns consecutive numbers into uncorrelated ones
+    static std::uint64_t mix(std::uint64_t x){
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+
+    std::vector<double> _weights;
+};
+
+//A ratio of two sums over the events, like the pure pT over the total pT, summed with the bootstrap weights of each replica
+class BootstrapRatio{
+public:
+    explicit BootstrapRatio(int replicas = 0): numerators(replicas, 0.0), denominators(replicas, 0.0){}
+
+    //Adds the numerator and denominator of one event to every replica. The replicas are allocated by the first event if there are none yet.
+    void fill(const BootstrapWeights &weights, double numerator, double denominator){
+        if(this->numerators.empty()){
+            this->numerators.assign(weights.replicas(), 0.0);
+            this->denominators.assign(weights.replicas(), 0.0);
+        }
+        const int replicas = weights.replicas();
+        const double *weight = weights.data();
+        double *numerators = this->numerators.data(), *denominators = this->denominators.data();
+        for(int i = 0; i < replicas; i++){    //More than a third of the weights are 0, but the loop adds them anyway instead of branching on each replica
+            numerators[i] += weight[i] * numerator;
+            denominators[i] += weight[i] * denominator;
+        }
+    }
+
+    void merge(const BootstrapRatio &other){
+        if(this->numerators.empty()){
+            *this = other;
+            return;
+        }
+        for(std::size_t i = 0; i < this->numerators.size() && i < other.numerators.size(); i++){
+            this->numerators[i] += other.numerators[i];
+            this->denominators[i] += other.denominators[i];
+        }
+    }
+
+    int replicas() const{
+        return this->numerators.size();
+    }
+
+    //Standard deviation of the ratio over the replicas, times scale, or 0 without replicas. Replicas with a zero denominator are left out.
+    double uncertainty(double scale = 1.0) const{
+        std::vector<double> ratios;
+        for(std::size_t i = 0; i < this->numerators.size(); i++){
+            if(this->denominators[i] != 0.0){
+                ratios.push_back(scale * this->numerators[i] / this->denominators[i]);
+            }
+        }
+        if(ratios.size() < 2){
+            return 0.0;
+        }
+        double mean = 0.0, variance = 0.0;
+        for(const double ratio: ratios){
+            mean += ratio;
+        }
+        mean /= ratios.size();
+        for(const double ratio: ratios){
+            variance += (ratio - mean) * (ratio - mean);
+        }
+        return std::sqrt(variance / (ratios.size() - 1));
+    }
+
+    std::vector<double> numerators, denominators;    //Per replica
+};
+
+//" +- uncertainty" followed by the unit, to print after the value of the ratio, or nothing without replicas
+inline std::string bootstrapUncertaintyText(const BootstrapRatio &ratio, double scale = 1.0, const std::string &unit = ""){
+    std::ostringstream text;
+    if(ratio.replicas() > 0){
+        text << " +- " << ratio.uncertainty(scale) << unit;
+    }
+    return text.str();
+}
\ No newline at end of file
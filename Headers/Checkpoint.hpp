@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+
+//Binary checkpoint of the accumulators of an analysis, so that a run that was stopped can be resumed from the last checkpoint instead of from the start.
+//The values are written in the byte order of the machine, one after the other, in the order the analysis writes them, and read back in the same order. The file starts with a magic string, a version and the name of the analysis.
+
+static const char checkpointMagic[8] = {'D', 'J', 'C', 'H', 'K', 'P', 'N', 'T'};
+static const std::uint32_t checkpointVersion = 10;
+
+class CheckpointWriter{
+public:
+    //The checkpoint is written to a temporary file that replaces path in close(), so a crash while writing leaves the previous checkpoint intact
+    CheckpointWriter(const std::string &path, const std::string &analysis): _path(path), _temporaryPath(path + ".tmp"), _file(_temporaryPath, std::ios::binary | std::ios::trunc){
+        this->_file.write(checkpointMagic, sizeof(checkpointMagic));
+        this->write(checkpointVersion);
+        this->write(analysis);
+    }
+
+    template<typename T> typename std::enable_if<std::is_arithmetic<T>::value>::type write(T value){
+        this->_file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    void write(const std::string &str){
+        this->write<std::uint64_t>(str.size());
+        this->_file.write(str.data(), str.size());
+    }
+    template<typename T> void write(const std::vector<T> &values){
+        this->write<std::uint64_t>(values.size());
+        for(const T &value: values){
+            this->write(value);
+        }
+    }
+    template<typename Key, typename Value> void write(const std::map<Key, Value> &map){
+        this->write<std::uint64_t>(map.size());
+        for(const std::pair<const Key, Value> &pair: map){
+            this->write(pair.first);
+            this->write(pair.second);
+        }
+    }
+    //Raw bytes, for types that aren't written by one of the other overloads, like the histograms in CheckpointRoot.hpp
+    void writeBytes(const void *data, std::size_t size){
+        this->_file.write(static_cast<const char*>(data), size);
+    }
+
+    bool close(){
+        this->_file.close();
+        if(!this->_file || std::rename(this->_temporaryPath.c_str(), this->_path.c_str()) != 0){
+            std::cerr << "Could not write the checkpoint to " << this->_path << "." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    const std::string _path, _temporaryPath;
+    std::ofstream _file;
+};
+
+class CheckpointReader{
+public:
+    CheckpointReader(): _good(false){}
+
+    //Returns false and prints why if path isn't a checkpoint of analysis
+    bool open(const std::string &path, const std::string &analysis){
+        this->_file.open(path, std::ios::binary);
+        char magic[sizeof(checkpointMagic)] = {};
+        this->_file.read(magic, sizeof(magic));
+        this->_good = static_cast<bool>(this->_file);
+        if(!this->_good){
+            std::cerr << "Could not read the checkpoint " << path << "." << std::endl;
+            return false;
+        }
+        std::uint32_t version = 0;
+        std::string checkpointAnalysis;
+        this->read(version);
+        this->read(checkpointAnalysis);
+        if(std::memcmp(magic, checkpointMagic, sizeof(magic)) != 0 || version != checkpointVersion || checkpointAnalysis != analysis){
+            std::cerr << path << " is not a checkpoint of " << analysis << " of version " << checkpointVersion << "." << std::endl;
+            this->_good = false;
+        }
+        return this->_good;
+    }
+
+    template<typename T> typename std::enable_if<std::is_arithmetic<T>::value>::type read(T &value){
+        this->_good = this->_good && this->_file.read(reinterpret_cast<char*>(&value), sizeof(value));
+    }
+    void read(std::string &str){
+        std::uint64_t size = 0;
+        this->read(size);
+        if(this->_good){
+            str.resize(size);
+            this->_good = static_cast<bool>(this->_file.read(&str[0], size));
+        }
+    }
+    template<typename T> void read(std::vector<T> &values){
+        std::uint64_t size = 0;
+        this->read(size);
+        values.clear();
+        for(std::uint64_t i = 0; i < size && this->_good; i++){
+            T value;
+            this->read(value);
+            values.push_back(value);
+        }
+    }
+    template<typename Key, typename Value> void read(std::map<Key, Value> &map){
+        std::uint64_t size = 0;
+        this->read(size);
+        map.clear();
+        for(std::uint64_t i = 0; i < size && this->_good; i++){
+            Key key;
+            this->read(key);
+            this->read(map[key]);
+        }
+    }
+    //Raw bytes, written with CheckpointWriter::writeBytes
+    void readBytes(void *data, std::size_t size){
+        this->_good = this->_good && this->_file.read(static_cast<char*>(data), size);
+    }
+
+    //False if anything couldn't be read, in which case the values that were read shouldn't be used
+    bool good() const{
+        return this->_good;
+    }
+    //For readers of other types that find the values they read don't fit
+    void fail(){
+        this->_good = false;
+    }
+
+private:
+    std::ifstream _file;
+    bool _good;
+};
\ No newline at end of file
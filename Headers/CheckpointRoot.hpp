@@ -0,0 +1,58 @@
+#pragma once
+
+#include <TH1D.h>
+#include <vector>
+#include <algorithm>
+#include "Checkpoint.hpp"
+
+//Writing ROOT histograms to the checkpoints of Checkpoint.hpp
+
+//The bin contents, the sums of squared weights and the statistics, so that the histogram continues exactly as if it hadn't been written
+inline void writeHistogram(CheckpointWriter &writer, const TH1D &histogram){
+    const int bins = histogram.GetNbinsX() + 2;    //Including underflow and overflow
+    writer.write(bins);
+    writer.writeBytes(histogram.GetArray(), bins * sizeof(double));
+    const bool sumw2 = histogram.GetSumw2N() > 0;
+    writer.write(sumw2);
+    if(sumw2){
+        writer.writeBytes(histogram.GetSumw2()->GetArray(), bins * sizeof(double));
+    }
+    double stats[TH1::kNstat] = {};
+    histogram.GetStats(stats);
+    writer.writeBytes(stats, sizeof(stats));
+    writer.write(histogram.GetEntries());
+}
+
+//The histogram must have the same binning as the one that was written
+inline void readHistogram(CheckpointReader &reader, TH1D &histogram){
+    int bins = 0;
+    reader.read(bins);
+    if(!reader.good() || bins != histogram.GetNbinsX() + 2){
+        reader.fail();
+        return;
+    }
+    std::vector<double> contents(bins), sumw2;
+    reader.readBytes(contents.data(), bins * sizeof(double));
+    bool hasSumw2 = false;
+    reader.read(hasSumw2);
+    if(hasSumw2){
+        sumw2.resize(bins);
+        reader.readBytes(sumw2.data(), bins * sizeof(double));
+    }
+    double stats[TH1::kNstat] = {};
+    double entries = 0.0;
+    reader.readBytes(stats, sizeof(stats));
+    reader.read(entries);
+    if(!reader.good()){
+        return;
+    }
+    std::copy(contents.begin(), contents.end(), histogram.GetArray());
+    if(hasSumw2){
+        if(histogram.GetSumw2N() == 0){
+            histogram.Sumw2();
+        }
+        std::copy(sumw2.begin(), sumw2.end(), histogram.GetSumw2()->GetArray());
+    }
+    histogram.PutStats(stats);
+    histogram.SetEntries(entries);
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "ParticleHandle.hpp"
+#include "ParticleSort.hpp"
+#include "Darkness.hpp"
+#include "Timing.hpp"
+
+//Compaction of the genealogy of an event to the particles the analyses need, leaving out the recoil copies, shower partons and hadronization bookkeeping of the event record.
+//The parents are rewired so that hasDarkAncestor and particleIsFromParton give exactly the same results on the compacted event: following highestEnergyParent from a kept particle visits the kept particles of the original walk, in the same order.
+
+//Keeps particle, the copies of it that each have it as their only child, and the children of the last copy, down to generations more generations of children (with their copies)
+static void keepDecayTree(FlatParticle particle, int generations, std::vector<bool> &keep){
+    keep[particle.index()] = true;
+    while(particle.numberOfChildren() == 1){
+        particle = particle.child(0);
+        keep[particle.index()] = true;
+    }
+    if(generations > 0){
+        for(std::size_t i = 0; i < particle.numberOfChildren(); i++){
+            keepDecayTree(particle.child(i), generations - 1, keep);
+        }
+    }
+}
+
+//The particles the analyses need: particles without parents (the beams), the final state, decayed hadrons and leptons (status 2), dark particles, and around each resonance particle in resonancePdgIds its parents, its decay products and their decay products, with the copies in between
+inline std::vector<bool> particlesToKeep(const FlatEvent &event, const std::vector<int> &resonancePdgIds){
+    std::vector<bool> keep(event.size, false);
+    for(std::size_t i = 0; i < event.size; i++){
+        const FlatParticle particle = event.particle(i);
+        if(particle.numberOfParents() == 0 || particle.status() == 1 || particle.status() == 2 || particle.status() == 4 || particleIsDark(particle)){
+            keep[i] = true;
+        }
+        if(std::find(resonancePdgIds.begin(), resonancePdgIds.end(), particle.pid()) != resonancePdgIds.end()){
+            keepDecayTree(particle, 2, keep);
+            for(std::size_t j = 0; j < particle.numberOfParents(); j++){
+                keepDecayTree(particle.parent(j), 2, keep);    //For PLOT_SECOND_CHILDREN=2, which starts from the parent of the resonance
+            }
+        }
+    }
+    return keep;
+}
+
+//Fills compacted with the particles of event that keep is true for, in the same order, and returns the index in compacted of each particle of event (-1 for the ones that were left out).
+//A kept particle whose parents are all kept keeps its parents and children, so the analyses can navigate around the resonance as before. Any other kept particle gets a single parent: the first kept particle found by following highestEnergyParent. The particles without parents must be kept.
+inline std::vector<int> compactGenealogy(const FlatEvent &event, const std::vector<bool> &keep, FlatEventStorage &compacted){
+    TIME_SCOPE("compacting the genealogy");
+    std::vector<int> newIndices(event.size, -1);
+    int kept = 0;
+    for(std::size_t i = 0; i < event.size; i++){
+        if(keep[i]){
+            newIndices[i] = kept++;
+        }
+    }
+
+    //The first kept particle on the highest-energy walk up from each particle, found once per particle like in particlesWithDarkAncestor
+    std::vector<int> keptAncestor(event.size, -1);
+    std::vector<std::uint32_t> path;
+    const auto firstKeptAncestor = [&](FlatParticle particle){
+        path.clear();
+        while(!keep[particle.index()] && keptAncestor[particle.index()] < 0){
+            path.push_back(particle.index());
+            particle = highestEnergyParent(particle);
+        }
+        const int ancestor = keep[particle.index()] ? newIndices[particle.index()] : keptAncestor[particle.index()];
+        for(const std::uint32_t index: path){
+            keptAncestor[index] = ancestor;
+        }
+        return ancestor;
+    };
+
+    std::vector<std::vector<std::uint32_t>> parents(kept), children(kept);
+    for(std::size_t i = 0; i < event.size; i++){
+        if(!keep[i]){
+            continue;
+        }
+        const FlatParticle particle = event.particle(i);
+        std::vector<std::uint32_t> &particleParents = parents[newIndices[i]];
+        bool allParentsKept = true;
+        for(std::size_t j = 0; j < particle.numberOfParents() && allParentsKept; j++){
+            allParentsKept = keep[particle.parent(j).index()];
+        }
+        if(allParentsKept){
+            for(std::size_t j = 0; j < particle.numberOfParents(); j++){
+                particleParents.push_back(newIndices[particle.parent(j).index()]);
+            }
+        }
+        else{
+            const FlatParticle parent = highestEnergyParent(particle);
+            particleParents.push_back(firstKeptAncestor(parent));
+        }
+        for(std::size_t j = 0; j < particle.numberOfChildren(); j++){
+            if(keep[particle.child(j).index()]){
+                children[newIndices[i]].push_back(newIndices[particle.child(j).index()]);
+            }
+        }
+    }
+    //The particles whose new parent isn't one of their old parents are also children of their new parent
+    for(std::size_t i = 0; i < event.size; i++){
+        if(keep[i] && parents[newIndices[i]].size() == 1 && !keep[highestEnergyParent(event.particle(i)).index()]){
+            children[parents[newIndices[i]][0]].push_back(newIndices[i]);
+        }
+    }
+
+    compacted.clear();
+    for(std::size_t i = 0; i < event.size; i++){
+        if(keep[i]){
+            compacted.add(event.particle(i), parents[newIndices[i]], children[newIndices[i]]);
+        }
+    }
+    compacted.setWeights(event.weights, event.numberOfWeights);
+    TIMING_COUNT("particles before compacting", event.size);
+    TIMING_COUNT("particles after compacting", kept);
+    return newIndices;
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+
+//64-bit FNV-1a hash of a sequence of values, for checksums of results and to find out whether the inputs of something changed. It is not a cryptographic hash.
+class ContentHash{
+public:
+    ContentHash(): _hash(14695981039346656037ull){}
+
+    ContentHash& add(const void *data, std::size_t size){
+        const unsigned char *bytes = static_cast<const unsigned char*>(data);
+        for(std::size_t i = 0; i < size; i++){
+            this->_hash = (this->_hash ^ bytes[i]) * 1099511628211ull;
+        }
+        return *this;
+    }
+    ContentHash& add(const char *str){
+        return this->add(str, std::strlen(str) + 1);    //Include the null character so that "ab" + "c" and "a" + "bc" hash differently
+    }
+    ContentHash& add(const std::string &str){
+        return this->add(str.c_str());
+    }
+    ContentHash& add(double value){
+        return this->add(&value, sizeof(value));
+    }
+    ContentHash& add(int value){
+        return this->add(&value, sizeof(value));
+    }
+    //The number of values followed by each value, for any type that add takes
+    template<typename T> ContentHash& add(const std::vector<T> &values){
+        this->add(static_cast<int>(values.size()));
+        for(const T &value: values){
+            this->add(value);
+        }
+        return *this;
+    }
+
+    std::uint64_t value() const{
+        return this->_hash;
+    }
+    //16 hex digits
+    std::string hex() const{
+        char buffer[17];
+        std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(this->_hash));
+        return buffer;
+    }
+
+private:
+    std::uint64_t _hash;
+};
\ No newline at end of file
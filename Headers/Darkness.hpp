@@ -1,102 +1,78 @@
-#pragma once
-
-#include <Rivet/Particle.hh>
-#include <Rivet/Jet.hh>
-#include <string>
-#include <regex>
-#include "ParticleSort.hpp"
-#include "GetEnvVars.hpp"
-
-static bool particleIsDark(const Rivet::Particle &particle){
-    static const std::regex darkParticleRegex(
-        getStringFromEnvVar(
-            //Allow to override dark regex by setting an environment variable
-            "DARK_REGEX",
-            //Default regex that matches PDGIDs of dark particles
-            std::string("^490[0-9][1-9][0-9]{2}$")
-        )
-    );
-    return std::regex_search(
-        std::to_string(particle.abspid()),
-        darkParticleRegex
-    );
-}
-
-static bool hasDarkAncestor(Rivet::Particle particle){
-    if(particleIsDark(particle)){
-        return true;
-    }
-    while(particle.parents().size() > 0){
-        particle = particlesByEnergy(particle.parents())[0];
-        if(particleIsDark(particle)){
-            return true;
-        }
-    }
-    return false;
-}
-
-static double pTDarkness(const Rivet::Jet &jet){
-    Rivet::FourMomentum momentum;
-    for(const Rivet::Particle &particle: jet.particles()){
-        if(hasDarkAncestor(particle)){
-            momentum += particle.momentum();
-        }
-    }
-    return std::min(momentum.pT() / jet.pT(), 1.0);
-}
-
-//Method to judge if a jet is dark. The default, recommended cut is 80%. 
-//Note that jet should be built including invisible particles.
-static bool jetIsDark(const Rivet::Jet &jet, double darknessCut = 0.8){
-    return pTDarkness(jet) >= darknessCut;
-}
-
-static double multiplicityDarkness(const Rivet::Jet &jet){
-    int multiplicity = 0;
-    for(const Rivet::Particle &particle: jet.particles()){
-        if(hasDarkAncestor(particle)){
-            multiplicity++;
-        }
-    }
-    return 1.0 * multiplicity / jet.particles().size();
-}
-
-static double pTInvisibility(const Rivet::Jet &jet){
-    Rivet::FourMomentum momentum;
-    for(const Rivet::Particle &particle: jet.particles()){
-        if(!particle.isVisible()){
-            momentum += particle.momentum();
-        }
-    }
-    return std::min(momentum.pT() / jet.pT(), 1.0);
-}
-
-static double multiplicityInvisibility(const Rivet::Jet &jet){
-    int multiplicity = 0;
-    for(const Rivet::Particle &particle: jet.particles()){
-        if(!particle.isVisible()){
-            multiplicity++;
-        }
-    }
-    return 1.0 * multiplicity / jet.particles().size();
-}
-
-static double pTLeptonFraction(const Rivet::Jet &jet){
-    Rivet::FourMomentum momentum;
-    for(const Rivet::Particle &particle: jet.particles()){
-        if(particle.isLepton()){
-            momentum += particle.momentum();
-        }
-    }
-    return std::min(momentum.pT() / jet.pT(), 1.0);
-}
-
-static double multiplicityLeptonFraction(const Rivet::Jet &jet){
-    int multiplicity = 0;
-    for(const Rivet::Particle &particle: jet.particles()){
-        if(particle.isLepton()){
-            multiplicity++;
-        }
-    }
-    return 1.0 * multiplicity / jet.particles().size();
-}
\ No newline at end of file
+#pragma once
+
+#include <string>
+#include <regex>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include "ParticleSort.hpp"
+#include "GetEnvVars.hpp"
+#include "Timing.hpp"
+
+static bool pdgIdIsDark(int pdgid){
+    static const std::regex darkParticleRegex(
+        getStringFromEnvVar(
+            //Allow to override dark regex by setting an environment variable
+            "DARK_REGEX",
+            //Default regex that matches PDGIDs of dark particles
+            std::string("^490[0-9][1-9][0-9]{2}$")
+        )
+    );
+    return std::regex_search(
+        std::to_string(std::abs(pdgid)),
+        darkParticleRegex
+    );
+}
+
+//The templates work on any particle type described in ParticleHandle.hpp, the overloads for Rivet particles and jets are in DarknessRivet.hpp
+
+template<typename Particle> bool particleIsDark(const Particle &particle){
+    return pdgIdIsDark(particle.pid());
+}
+
+//Follows the highest-energy parent at each step, like the Rivet version, without allocating anything
+template<typename Particle> bool hasDarkAncestor(Particle particle){
+    bool dark = particleIsDark(particle);
+#ifdef DARKJET_TIMING
+    std::size_t depth = 0;
+#endif
+    while(!dark && particle.numberOfParents() > 0){
+        particle = highestEnergyParent(particle);
+        dark = particleIsDark(particle);
+#ifdef DARKJET_TIMING
+        depth++;
+#endif
+    }
+    TIMING_RECORD("hasDarkAncestor walk depth", depth);
+    return dark;
+}
+
+//Versions of pTDarkness and multiplicityDarkness for a jet given as a range of its constituents, with the jet pT taken as the pT of the sum of the constituents
+template<typename Constituents> double pTDarkness(const Constituents &constituents){
+    double px = 0.0, py = 0.0, darkPx = 0.0, darkPy = 0.0;
+    for(const auto &particle: constituents){
+        px += particle.px();
+        py += particle.py();
+        if(hasDarkAncestor(particle)){
+            darkPx += particle.px();
+            darkPy += particle.py();
+        }
+    }
+    return std::min(std::hypot(darkPx, darkPy) / std::hypot(px, py), 1.0);
+}
+
+template<typename Constituents> double multiplicityDarkness(const Constituents &constituents){
+    int multiplicity = 0, size = 0;
+    for(const auto &particle: constituents){
+        size++;
+        if(hasDarkAncestor(particle)){
+            multiplicity++;
+        }
+    }
+    return 1.0 * multiplicity / size;
+}
+
+//The overloads for Rivet particles and jets, whenever Rivet is available, so that analyses that only include Darkness.hpp keep working
+#if __has_include(<Rivet/Particle.hh>)
+#include "DarknessRivet.hpp"
+#endif
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <Rivet/Particle.hh>
+#include <Rivet/Jet.hh>
+#include <cmath>
+#include <algorithm>
+#include "Darkness.hpp"
+#include "ParticleHandle.hpp"
+
+//The functions of Darkness.hpp for Rivet particles and jets
+
+static bool particleIsDark(const Rivet::Particle &particle){
+    return pdgIdIsDark(particle.abspid());
+}
+
+static bool hasDarkAncestor(Rivet::Particle particle){
+    //Walk the HepMC genealogy directly, since each Rivet::Particle::parents() call makes a vector of new Rivet particles
+    if(particle.genParticle() == nullptr){
+        return particleIsDark(particle);
+    }
+    return hasDarkAncestor(HepMCParticle(particle.genParticle()));
+}
+
+static double pTDarkness(const Rivet::Jet &jet){
+    Rivet::FourMomentum momentum;
+    for(const Rivet::Particle &particle: jet.particles()){
+        if(hasDarkAncestor(particle)){
+            momentum += particle.momentum();
+        }
+    }
+    return std::min(momentum.pT() / jet.pT(), 1.0);
+}
+
+//Method to judge if a jet is dark. The default, recommended cut is 80%. 
+//Note that jet should be built including invisible particles.
+static bool jetIsDark(const Rivet::Jet &jet, double darknessCut = 0.8){
+    return pTDarkness(jet) >= darknessCut;
+}
+
+static double multiplicityDarkness(const Rivet::Jet &jet){
+    int multiplicity = 0;
+    for(const Rivet::Particle &particle: jet.particles()){
+        if(hasDarkAncestor(particle)){
+            multiplicity++;
+        }
+    }
+    return 1.0 * multiplicity / jet.particles().size();
+}
+
+static double pTInvisibility(const Rivet::Jet &jet){
+    Rivet::FourMomentum momentum;
+    for(const Rivet::Particle &particle: jet.particles()){
+        if(!particle.isVisible()){
+            momentum += particle.momentum();
+        }
+    }
+    return std::min(momentum.pT() / jet.pT(), 1.0);
+}
+
+static double multiplicityInvisibility(const Rivet::Jet &jet){
+    int multiplicity = 0;
+    for(const Rivet::Particle &particle: jet.particles()){
+        if(!particle.isVisible()){
+            multiplicity++;
+        }
+    }
+    return 1.0 * multiplicity / jet.particles().size();
+}
+
+static double pTLeptonFraction(const Rivet::Jet &jet){
+    Rivet::FourMomentum momentum;
+    for(const Rivet::Particle &particle: jet.particles()){
+        if(particle.isLepton()){
+            momentum += particle.momentum();
+        }
+    }
+    return std::min(momentum.pT() / jet.pT(), 1.0);
+}
+
+static double multiplicityLeptonFraction(const Rivet::Jet &jet){
+    int multiplicity = 0;
+    for(const Rivet::Particle &particle: jet.particles()){
+        if(particle.isLepton()){
+            multiplicity++;
+        }
+    }
+    return 1.0 * multiplicity / jet.particles().size();
+}
\ No newline at end of file
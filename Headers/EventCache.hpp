@@ -0,0 +1,298 @@
+#pragma once
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include "ParticleHandle.hpp"
+
+//Binary columnar event cache. Layout (native byte order, every block starts at a multiple of 8 bytes):
+//  File header:  EventCacheHeader
+//  Each event:   EventCacheEventHeader, then the columns px, py, pz, energy, productionTime (double), pid, status (int32),
+//                parentOffsets (uint32, n + 1 entries), parentIndices (uint32), childOffsets (uint32, n + 1 entries), childIndices (uint32), weights (double)
+//  Offset table: the byte offset of each event (uint64), at header.offsetTable
+struct EventCacheHeader{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t numberOfEvents;
+    std::uint64_t offsetTable;
+};
+
+struct EventCacheEventHeader{
+    std::uint64_t numberOfParticles;
+    std::uint64_t numberOfParentIndices;
+    std::uint64_t numberOfChildIndices;
+    std::int64_t eventNumber;
+    std::uint64_t numberOfWeights;
+};
+
+static const char eventCacheMagic[8] = {'D', 'J', 'E', 'V', 'C', 'A', 'C', 'H'};
+static const std::uint32_t eventCacheVersion = 2;
+
+//Whether the file at path starts like an event cache, to decide whether to read it with EventCacheReader or HepMC3
+inline bool fileIsEventCache(const std::string &path){
+    char magic[sizeof(eventCacheMagic)] = {};
+    std::ifstream file(path, std::ios::binary);
+    file.read(magic, sizeof(magic));
+    return file && std::memcmp(magic, eventCacheMagic, sizeof(magic)) == 0;
+}
+
+//Writes events one at a time to a new cache file. The offset table is written by close(), which the destructor calls if needed.
+class EventCacheWriter{
+public:
+    EventCacheWriter(){}
+    explicit EventCacheWriter(const std::string &path){
+        this->open(path);
+    }
+    ~EventCacheWriter(){
+        this->close();
+    }
+
+    bool open(const std::string &path){
+        this->_file.open(path, std::ios::binary | std::ios::trunc);
+        if(!this->_file){
+            std::cerr << "Could not open " << path << " for writing." << std::endl;
+            return false;
+        }
+        this->_path = path;
+        EventCacheHeader header{};
+        this->_file.write(reinterpret_cast<const char*>(&header), sizeof(header));    //Filled in by close()
+        this->_offsets.clear();
+        return true;
+    }
+
+    //Returns false and prints why if the event couldn't be written, for example because the disk is full. The cache is then unusable, and close() fails too.
+    bool write(const FlatEvent &event, std::int64_t eventNumber){
+        if(!this->_file){
+            return false;
+        }
+        this->_offsets.push_back(this->_file.tellp());
+        const std::size_t n = event.size;
+        const EventCacheEventHeader header{n, event.parentOffsets[n], event.childOffsets[n], eventNumber, event.numberOfWeights};
+        this->_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for(const double *column: {event.px, event.py, event.pz, event.energy, event.productionTime}){
+            this->writeColumn(column, n);
+        }
+        this->writeColumn(event.pid, n);
+        this->writeColumn(event.status, n);
+        this->writeColumn(event.parentOffsets, n + 1);
+        this->writeColumn(event.parentIndices, header.numberOfParentIndices);
+        this->writeColumn(event.childOffsets, n + 1);
+        this->writeColumn(event.childIndices, header.numberOfChildIndices);
+        this->writeColumn(event.weights, header.numberOfWeights);
+        if(!this->_file){
+            std::cerr << "Could not write event " << eventNumber << " to " << this->_path << "." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool close(){
+        if(!this->_file.is_open()){
+            return true;
+        }
+        if(!this->_file){
+            this->_file.close();    //Without the header, so that the reader rejects the file
+            return false;
+        }
+        EventCacheHeader header{};
+        std::memcpy(header.magic, eventCacheMagic, sizeof(header.magic));
+        header.version = eventCacheVersion;
+        header.numberOfEvents = this->_offsets.size();
+        header.offsetTable = this->_file.tellp();
+        this->_file.write(reinterpret_cast<const char*>(this->_offsets.data()), 8 * this->_offsets.size());
+        this->_file.seekp(0);
+        this->_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        this->_file.close();
+        return !this->_file.fail();
+    }
+
+private:
+    //Writes the column followed by zeros up to a multiple of 8 bytes
+    template<typename T> void writeColumn(const T *column, std::size_t size){
+        static const char zeros[8] = {};
+        this->_file.write(reinterpret_cast<const char*>(column), sizeof(T) * size);
+        this->_file.write(zeros, (8 - sizeof(T) * size % 8) % 8);
+    }
+
+    std::ofstream _file;
+    std::string _path;
+    std::vector<std::uint64_t> _offsets;
+};
+
+//Memory-maps a cache file. The events are returned as FlatEvent views directly into the mapped file, so reading an event doesn't copy anything.
+class EventCacheReader{
+public:
+    EventCacheReader(): _data(nullptr), _size(0), _header(nullptr), _offsets(nullptr){}
+    explicit EventCacheReader(const std::string &path): EventCacheReader(){
+        this->open(path);
+    }
+    EventCacheReader(const EventCacheReader&) = delete;
+    EventCacheReader& operator=(const EventCacheReader&) = delete;
+    ~EventCacheReader(){
+        this->close();
+    }
+
+    bool open(const std::string &path){
+        this->close();
+        const int file = ::open(path.c_str(), O_RDONLY);
+        struct stat status;
+        if(file < 0 || fstat(file, &status) != 0){
+            std::cerr << "Could not open " << path << "." << std::endl;
+            if(file >= 0){
+                ::close(file);
+            }
+            return false;
+        }
+        this->_size = status.st_size;
+        void *data = this->_size >= sizeof(EventCacheHeader) ? mmap(nullptr, this->_size, PROT_READ, MAP_SHARED, file, 0) : MAP_FAILED;
+        ::close(file);    //The mapping stays valid after the file is closed
+        if(data == MAP_FAILED){
+            std::cerr << "Could not map " << path << " into memory." << std::endl;
+            return false;
+        }
+        this->_data = static_cast<const char*>(data);
+        this->_header = reinterpret_cast<const EventCacheHeader*>(this->_data);
+        const EventCacheHeader &header = *this->_header;
+        if(std::memcmp(header.magic, eventCacheMagic, sizeof(eventCacheMagic)) != 0 || header.version != eventCacheVersion || header.offsetTable < sizeof(EventCacheHeader) || header.offsetTable % 8 != 0 || header.offsetTable > this->_size || header.numberOfEvents > (this->_size - header.offsetTable) / 8){
+            std::cerr << path << " is not an event cache of version " << eventCacheVersion << ", or it was not closed properly." << std::endl;
+            this->close();
+            return false;
+        }
+        this->_offsets = reinterpret_cast<const std::uint64_t*>(this->_data + header.offsetTable);
+        for(std::size_t i = 0; i < header.numberOfEvents; i++){
+            if(!this->eventFits(i)){
+                std::cerr << path << " is damaged: event " << i << " doesn't fit in the file, or its parents or children aren't particles of the event." << std::endl;
+                this->close();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void close(){
+        if(this->_data != nullptr){
+            munmap(const_cast<char*>(this->_data), this->_size);
+        }
+        this->_data = nullptr;
+        this->_header = nullptr;
+        this->_offsets = nullptr;
+        this->_size = 0;
+    }
+
+    bool isOpen() const{
+        return this->_data != nullptr;
+    }
+
+    std::size_t size() const{
+        return this->_header ? this->_header->numberOfEvents : 0;
+    }
+
+    std::int64_t eventNumber(std::size_t i) const{
+        return reinterpret_cast<const EventCacheEventHeader*>(this->_data + this->_offsets[i])->eventNumber;
+    }
+
+    //Event number i (counting from 0 in the order they were written), which stays valid as long as the reader is open
+    FlatEvent event(std::size_t i) const{
+        const char *position = this->_data + this->_offsets[i];
+        const EventCacheEventHeader *header = reinterpret_cast<const EventCacheEventHeader*>(position);
+        position += sizeof(EventCacheEventHeader);
+        const std::size_t n = header->numberOfParticles;
+        FlatEvent event;
+        event.size = n;
+        event.px = column<double>(position, n);
+        event.py = column<double>(position, n);
+        event.pz = column<double>(position, n);
+        event.energy = column<double>(position, n);
+        event.productionTime = column<double>(position, n);
+        event.pid = column<int>(position, n);
+        event.status = column<int>(position, n);
+        event.parentOffsets = column<std::uint32_t>(position, n + 1);
+        event.parentIndices = column<std::uint32_t>(position, header->numberOfParentIndices);
+        event.childOffsets = column<std::uint32_t>(position, n + 1);
+        event.childIndices = column<std::uint32_t>(position, header->numberOfChildIndices);
+        event.numberOfWeights = header->numberOfWeights;
+        event.weights = column<double>(position, header->numberOfWeights);
+        return event;
+    }
+
+    //Tells the kernel that the whole file will be read, so that it can read ahead
+    void willReadAll() const{
+        if(this->_data != nullptr){
+            madvise(const_cast<char*>(this->_data), this->_size, MADV_WILLNEED);
+        }
+    }
+
+private:
+    //Whether the header and columns of event i lie between the file header and the offset table, so that the columns that event(i) returns lie in the mapped file, and its genealogy stays inside the event (see genealogyFits).
+    //Besides the event headers, only the parent and child columns are read, each in one branch-free pass, so this takes a small part of the time it takes to analyze the events.
+    bool eventFits(std::size_t i) const{
+        const std::uint64_t end = this->_header->offsetTable;
+        std::uint64_t position = this->_offsets[i];
+        if(position < sizeof(EventCacheHeader) || position % 8 != 0 || position > end || end - position < sizeof(EventCacheEventHeader)){
+            return false;
+        }
+        const EventCacheEventHeader &header = *reinterpret_cast<const EventCacheEventHeader*>(this->_data + position);
+        position += sizeof(EventCacheEventHeader);
+        const std::uint64_t n = header.numberOfParticles;
+        if(n >= UINT32_MAX){    //The parent and child offsets are 32-bit
+            return false;
+        }
+        std::uint64_t parentOffsets = 0, parentIndices = 0, childOffsets = 0, childIndices = 0;
+        const bool fits = skipColumn(position, end, n, 5 * sizeof(double))    //px, py, pz, energy and productionTime, which need no padding
+            && skipColumn(position, end, n, sizeof(int)) && skipColumn(position, end, n, sizeof(int))
+            && (parentOffsets = position, skipColumn(position, end, n + 1, sizeof(std::uint32_t)))
+            && (parentIndices = position, skipColumn(position, end, header.numberOfParentIndices, sizeof(std::uint32_t)))
+            && (childOffsets = position, skipColumn(position, end, n + 1, sizeof(std::uint32_t)))
+            && (childIndices = position, skipColumn(position, end, header.numberOfChildIndices, sizeof(std::uint32_t)))
+            && skipColumn(position, end, header.numberOfWeights, sizeof(double));
+        return fits
+            && this->genealogyFits(parentOffsets, parentIndices, n, header.numberOfParentIndices)
+            && this->genealogyFits(childOffsets, childIndices, n, header.numberOfChildIndices);
+    }
+
+    //Whether the n + 1 offsets at offsetsPosition never decrease and end at numberOfIndices, and the indices at indicesPosition are all below n, so that FlatParticle::parent and FlatParticle::child only return particles of the same event
+    bool genealogyFits(std::uint64_t offsetsPosition, std::uint64_t indicesPosition, std::uint64_t n, std::uint64_t numberOfIndices) const{
+        const std::uint32_t *offsets = reinterpret_cast<const std::uint32_t*>(this->_data + offsetsPosition);
+        const std::uint32_t *indices = reinterpret_cast<const std::uint32_t*>(this->_data + indicesPosition);
+        if(offsets[n] != numberOfIndices){
+            return false;
+        }
+        bool fits = true;    //Without early returns, so that the loops have no branches
+        for(std::uint64_t i = 0; i < n; i++){
+            fits &= offsets[i] <= offsets[i + 1];
+        }
+        for(std::uint64_t i = 0; i < numberOfIndices; i++){
+            fits &= indices[i] < n;
+        }
+        return fits;
+    }
+
+    //Moves position past a column of size values of bytesPerValue bytes and its padding, and returns false if it would go past end
+    static bool skipColumn(std::uint64_t &position, std::uint64_t end, std::uint64_t size, std::uint64_t bytesPerValue){
+        if(size > (end - position) / bytesPerValue){
+            return false;
+        }
+        position += (bytesPerValue * size + 7) / 8 * 8;
+        return position <= end;
+    }
+
+    //Returns a pointer to the column at position and moves position past it and its padding
+    template<typename T> static const T* column(const char *&position, std::size_t size){
+        const T *column = reinterpret_cast<const T*>(position);
+        position += (sizeof(T) * size + 7) / 8 * 8;
+        return column;
+    }
+
+    const char *_data;
+    std::size_t _size;
+    const EventCacheHeader *_header;
+    const std::uint64_t *_offsets;
+};
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <fastjet/PseudoJet.hh>
+#include <fastjet/JetDefinition.hh>
+#include <fastjet/ClusterSequence.hh>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include "GetEnvVars.hpp"
+
+//Controls for how much of an event is clustered and how many of its jets are kept, so that the cost of the clustering and of everything done per jet follows what the analysis uses instead of the number of particles in the final state.
+//The defaults cluster everything with the strategy FastJet picks and keep all jets, like before these options existed.
+
+//The FastJet strategy with the given name: "Best" (FastJet picks one from the number of particles), "N2Tiled" or "N2Plain"
+inline fastjet::Strategy clusteringStrategy(const std::string &name){
+    if(name == "N2Tiled"){
+        return fastjet::N2Tiled;
+    }
+    if(name == "N2Plain"){
+        return fastjet::N2Plain;
+    }
+    if(name != "Best"){
+        std::cout << "Unknown clustering strategy " << name << ", using Best instead." << std::endl;
+    }
+    return fastjet::Best;
+}
+
+struct ClusteringOptions{
+    ClusteringOptions():
+        minJetPT(getDoubleFromEnvVar("MIN_JET_PT", 0.0)),
+        maxParticleEta(getDoubleFromEnvVar("MAX_PARTICLE_ETA", 0.0)),
+        maxJetEta(getDoubleFromEnvVar("MAX_JET_ETA", 0.0)),
+        strategy(clusteringStrategy(getStringFromEnvVar("CLUSTERING_STRATEGY", std::string("Best")))),
+        maxJets(getIntFromEnvVar("MAX_JETS", 0))
+    {}
+
+    double minJetPT;          //In GeV
+    double maxParticleEta;    //|eta| cut on the particles before clustering, 0 for no cut
+    double maxJetEta;         //|eta| cut on the jets after clustering, 0 for no cut
+    fastjet::Strategy strategy;
+    int maxJets;              //Only the maxJets leading jets are kept, 0 to keep all
+};
+
+inline bool particleIsClustered(double eta, const ClusteringOptions &options){
+    return options.maxParticleEta <= 0.0 || std::abs(eta) < options.maxParticleEta;
+}
+
+//Removes the jets after the MAX_JETS leading ones from jets, which must be sorted by pT
+template<typename Jets> void keepLeadingJets(Jets &jets, const ClusteringOptions &options){
+    if(options.maxJets > 0 && jets.size() > static_cast<std::size_t>(options.maxJets)){
+        jets.erase(jets.begin() + options.maxJets, jets.end());
+    }
+}
+
+//Jet definition with the strategy of options
+inline fastjet::JetDefinition clusteringJetDefinition(fastjet::JetAlgorithm algorithm, double radius, const ClusteringOptions &options){
+    return fastjet::JetDefinition(algorithm, radius, options.strategy);
+}
+
+//The jets of clusterSequence with pT >= MIN_JET_PT and inside MAX_JET_ETA, sorted by pT, and only the MAX_JETS leading ones of those
+inline std::vector<fastjet::PseudoJet> selectedJets(const fastjet::ClusterSequence &clusterSequence, const ClusteringOptions &options){
+    std::vector<fastjet::PseudoJet> jets;
+    for(const fastjet::PseudoJet &jet: fastjet::sorted_by_pt(clusterSequence.inclusive_jets(options.minJetPT))){
+        if(options.maxJetEta <= 0.0 || std::abs(jet.eta()) < options.maxJetEta){
+            jets.push_back(jet);
+        }
+    }
+    keepLeadingJets(jets, options);
+    return jets;
+}
\ No newline at end of file
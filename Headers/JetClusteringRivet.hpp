@@ -0,0 +1,50 @@
+#pragma once
+
+#include <Rivet/Particle.hh>
+#include <Rivet/Jet.hh>
+#include <Rivet/Tools/Cuts.hh>
+#include <fastjet/ClusterSequence.hh>
+#include <vector>
+#include "JetClustering.hpp"
+
+//The clustering options of JetClustering.hpp as cuts for Rivet's FastJets projections, and clustering without a FastJets projection
+
+//Cut for the final state that a FastJets projection clusters
+inline Rivet::Cut particleCut(const ClusteringOptions &options){
+    return options.maxParticleEta > 0.0 ? Rivet::Cut(Rivet::Cuts::abseta < options.maxParticleEta) : Rivet::Cuts::OPEN;
+}
+
+//Cut to give to FastJets::jetsByPt, which is followed by keepLeadingJets
+inline Rivet::Cut jetCut(const ClusteringOptions &options){
+    const Rivet::Cut pTCut = Rivet::Cuts::pT >= options.minJetPT * Rivet::GeV;
+    return options.maxJetEta > 0.0 ? Rivet::Cut(pTCut && Rivet::Cuts::abseta < options.maxJetEta) : pTCut;
+}
+
+//Clusters particles like a FastJets projection with jetDefinition and JetAlg::Muons::ALL would, and returns the jets that pass cut sorted by pT. Unlike with FastJets, the particles don't have to be from the event (like the pile-up of PileUpRivet.hpp), and the recombiner of jetDefinition can belong to the analysis.
+//The user indices are the positions in particles plus 1, like in FastJets.
+inline Rivet::Jets clusterParticles(const Rivet::Particles &particles, const fastjet::JetDefinition &jetDefinition, const Rivet::Cut &cut){
+    std::vector<fastjet::PseudoJet> inputs;
+    for(std::size_t i = 0; i < particles.size(); i++){
+        inputs.push_back(fastjet::PseudoJet(particles[i].px(), particles[i].py(), particles[i].pz(), particles[i].E()));
+        inputs.back().set_user_index(i + 1);
+    }
+    fastjet::ClusterSequence *clusterSequence = new fastjet::ClusterSequence(inputs, jetDefinition);
+    Rivet::Jets jets;
+    for(const fastjet::PseudoJet &pseudoJet: clusterSequence->inclusive_jets()){
+        Rivet::Particles constituents;
+        for(const fastjet::PseudoJet &constituent: pseudoJet.constituents()){
+            constituents.push_back(particles[constituent.user_index() - 1]);
+        }
+        const Rivet::Jet jet(pseudoJet, constituents);
+        if(cut->accept(jet)){
+            jets.push_back(jet);
+        }
+    }
+    if(jets.empty()){
+        delete clusterSequence;
+    }
+    else{
+        clusterSequence->delete_self_when_unused();    //Keeps the constituents of the jets available for as long as the jets exist, like in FastJets
+    }
+    return Rivet::sortByPt(jets);
+}
\ No newline at end of file
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <fastjet/PseudoJet.hh>
+#include <fastjet/JetDefinition.hh>
+#include <vector>
+#include <cstdint>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include "Darkness.hpp"
+#include "ParticleHandle.hpp"
+#include "ParticleSort.hpp"
+
+//The dark, invisible and lepton content of jets, without walking the genealogy of their constituents again.
+//Before clustering, give a DarknessRecombiner the composition of each particle in the order of their user indices, and cluster with its jetDefinition. It adds up the compositions of the pseudojets it merges, so every jet and subjet of the cluster sequence has its composition in constant time.
+
+//Vector sum of the transverse momenta, scalar sum of the pT and number of some of the constituents of a jet
+struct ConstituentSum{
+    double px = 0.0, py = 0.0, scalarPT = 0.0;
+    int multiplicity = 0;
+
+    double pT() const{
+        return std::hypot(this->px, this->py);
+    }
+    ConstituentSum& operator+=(const ConstituentSum &other){
+        this->px += other.px;
+        this->py += other.py;
+        this->scalarPT += other.scalarPT;
+        this->multiplicity += other.multiplicity;
+        return *this;
+    }
+};
+
+struct JetComposition{
+    ConstituentSum all, dark, invisible, lepton;
+
+    JetComposition(){}
+    //Composition of a single particle
+    JetComposition(double px, double py, bool isDark, bool isInvisible, bool isLepton){
+        this->all = ConstituentSum{px, py, std::hypot(px, py), 1};
+        if(isDark){
+            this->dark = this->all;
+        }
+        if(isInvisible){
+            this->invisible = this->all;
+        }
+        if(isLepton){
+            this->lepton = this->all;
+        }
+    }
+
+    JetComposition& operator+=(const JetComposition &other){
+        this->all += other.all;
+        this->dark += other.dark;
+        this->invisible += other.invisible;
+        this->lepton += other.lepton;
+        return *this;
+    }
+
+    //The same fractions as the functions for Rivet jets in DarknessRivet.hpp, with the jet pT taken as the pT of the sum of the constituents
+    double pTDarkness() const{
+        return this->pTFraction(this->dark);
+    }
+    double multiplicityDarkness() const{
+        return this->multiplicityFraction(this->dark);
+    }
+    double pTInvisibility() const{
+        return this->pTFraction(this->invisible);
+    }
+    double multiplicityInvisibility() const{
+        return this->multiplicityFraction(this->invisible);
+    }
+    double pTLeptonFraction() const{
+        return this->pTFraction(this->lepton);
+    }
+    double multiplicityLeptonFraction() const{
+        return this->multiplicityFraction(this->lepton);
+    }
+
+private:
+    double pTFraction(const ConstituentSum &part) const{
+        return this->all.multiplicity > 0 ? std::min(part.pT() / this->all.pT(), 1.0) : 0.0;
+    }
+    double multiplicityFraction(const ConstituentSum &part) const{
+        return this->all.multiplicity > 0 ? 1.0 * part.multiplicity / this->all.multiplicity : 0.0;
+    }
+};
+
+//The composition of a pseudojet that the DarknessRecombiner merged
+class JetCompositionInfo: public fastjet::PseudoJet::UserInfoBase{
+public:
+    explicit JetCompositionInfo(const JetComposition &composition): composition(composition){}
+
+    const JetComposition composition;
+};
+
+//E-scheme recombiner that also adds up the compositions of the pseudojets it merges. Each analysis (or thread) keeps its own and gives it the particles of every event before clustering.
+//The particles keep their user index and their compositions stay in the recombiner, so only the merges allocate, one JetCompositionInfo each.
+class DarknessRecombiner: public fastjet::JetDefinition::DefaultRecombiner{
+public:
+    //firstIndex is the user index of the first particle that is clustered
+    explicit DarknessRecombiner(int firstIndex = 0): fastjet::JetDefinition::DefaultRecombiner(fastjet::E_scheme), _firstIndex(firstIndex){}
+
+    //Forgets the particles of the previous event
+    void clear(){
+        this->_inputs.clear();
+        this->_energies.clear();
+    }
+    //Adds the particle with the next user index. The energy is used to check that the user indices are what they should be.
+    void add(const JetComposition &composition, double energy){
+        this->_inputs.push_back(composition);
+        this->_energies.push_back(energy);
+    }
+
+    //The jet definition to cluster with, which refers to this recombiner and is only valid as long as it exists
+    fastjet::JetDefinition jetDefinition(fastjet::JetAlgorithm algorithm, double radius, fastjet::Strategy strategy = fastjet::Best) const{
+        fastjet::JetDefinition jetDefinition(algorithm, radius, strategy);
+        jetDefinition.set_recombiner(this);
+        return jetDefinition;
+    }
+
+    //The composition of a pseudojet from a cluster sequence with this recombiner: the sum this recombiner stored for merged pseudojets, the input for particles.
+    //Pseudojets with a user index below firstIndex that this recombiner didn't merge, like ghosts, count as nothing. Throws an std::runtime_error if the energy of a particle doesn't match the one it was given.
+    const JetComposition& composition(const fastjet::PseudoJet &jet) const{
+        static const JetComposition empty;
+        const JetCompositionInfo *info = dynamic_cast<const JetCompositionInfo*>(jet.user_info_ptr());
+        if(info != nullptr){
+            return info->composition;
+        }
+        const int index = jet.user_index() - this->_firstIndex;
+        if(index < 0){
+            return empty;
+        }
+        if(static_cast<std::size_t>(index) >= this->_inputs.size() || std::abs(jet.E() - this->_energies[index]) > 1e-9 * std::max(std::abs(this->_energies[index]), 1.0)){
+            throw std::runtime_error("The particles clustered with the DarknessRecombiner aren't the ones it was given.");
+        }
+        return this->_inputs[index];
+    }
+
+    virtual std::string description() const override{
+        return "E scheme recombination, also adding up the dark, invisible and lepton content";
+    }
+
+    virtual void recombine(const fastjet::PseudoJet &a, const fastjet::PseudoJet &b, fastjet::PseudoJet &ab) const override{
+        fastjet::JetDefinition::DefaultRecombiner::recombine(a, b, ab);
+        JetComposition composition = this->composition(a);
+        composition += this->composition(b);
+        ab.set_user_info(new JetCompositionInfo(composition));
+    }
+
+private:
+    const int _firstIndex;
+    std::vector<JetComposition> _inputs;
+    std::vector<double> _energies;
+};
+
+//hasDarkAncestor for every particle of the event at once. Each walk stops at the first particle whose answer is already known, so every particle is visited only once.
+inline std::vector<bool> particlesWithDarkAncestor(const FlatEvent &event){
+    std::vector<signed char> dark(event.size, -1);    //-1 while unknown
+    std::vector<std::uint32_t> path;
+    for(std::size_t i = 0; i < event.size; i++){
+        FlatParticle particle = event.particle(i);
+        path.clear();
+        while(dark[particle.index()] < 0){
+            path.push_back(particle.index());
+            if(particleIsDark(particle)){
+                dark[particle.index()] = 1;
+            }
+            else if(particle.numberOfParents() == 0){
+                dark[particle.index()] = 0;
+            }
+            else{
+                particle = highestEnergyParent(particle);
+            }
+        }
+        for(const std::uint32_t index: path){
+            dark[index] = dark[particle.index()];
+        }
+    }
+    return std::vector<bool>(dark.begin(), dark.end());
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Rivet/Particle.hh>
+#include <Rivet/Jet.hh>
+#include "JetComposition.hpp"
+#include "DarknessRivet.hpp"
+
+//The jet composition of JetComposition.hpp for Rivet analyses, which cluster their particles themselves with clusterParticles (see JetClusteringRivet.hpp) and the jet definition of their own DarknessRecombiner.
+//A FastJets projection can't be used for this, since Rivet shares FastJets projections with the same algorithm, radius and particles between analyses, whatever their recombiner.
+
+//clusterParticles numbers the particles from 1 like FastJets, so the recombiner of an analysis should be DarknessRecombiner(clusterParticlesFirstIndex)
+static constexpr int clusterParticlesFirstIndex = 1;
+
+//Gives the recombiner the particles of the event, which must be the particles that are clustered, in the same order.
+//isDark(particle) says if the particle has a dark ancestor, so that an analysis that already knows can avoid walking the genealogy again.
+template<typename IsDark> void setJetCompositionInputs(DarknessRecombiner &recombiner, const Rivet::Particles &particles, IsDark isDark){
+    recombiner.clear();
+    for(const Rivet::Particle &particle: particles){
+        recombiner.add(JetComposition(particle.px(), particle.py(), isDark(particle), !particle.isVisible(), particle.isLepton()), particle.E());
+    }
+}
+
+inline void setJetCompositionInputs(DarknessRecombiner &recombiner, const Rivet::Particles &particles){
+    setJetCompositionInputs(recombiner, particles, [](const Rivet::Particle &particle){
+        return hasDarkAncestor(particle);
+    });
+}
+
+//The composition of a jet that was clustered with the jet definition of recombiner
+inline const JetComposition& jetComposition(const Rivet::Jet &jet, const DarknessRecombiner &recombiner){
+    return recombiner.composition(jet.pseudojet());
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <HepMC3/GenEvent.h>
+#include <HepMC3/GenRunInfo.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "ParticleHandle.hpp"
+
+//Filling with all weight variations of the events in one pass, like the shower variations Pythia adds to each event. Each bin or sum has a contiguous slot with one entry per weight, and a fill adds the weight vector of the event to the slot with addWeights.
+
+//The weights of the event, or a single weight of 1 for events without weights
+inline std::vector<double> eventWeights(const HepMC3::GenEvent &event){
+    return event.weights().empty() ? std::vector<double>{1.0} : event.weights();
+}
+
+//The weights of a flat event, or a single weight of 1 for events without weights
+inline std::vector<double> eventWeights(const FlatEvent &event){
+    return event.numberOfWeights == 0 ? std::vector<double>{1.0} : std::vector<double>(event.weights, event.weights + event.numberOfWeights);
+}
+
+//"Weight 0", "Weight 1", ..., with at least one name for events without weights
+inline std::vector<std::string> defaultWeightNames(std::size_t weights){
+    std::vector<std::string> names;
+    for(std::size_t i = 0; i < std::max<std::size_t>(weights, 1); i++){
+        names.push_back("Weight " + std::to_string(i));
+    }
+    return names;
+}
+
+//The names of the weights of the event from its run info, or the default names if the run info doesn't have them
+inline std::vector<std::string> eventWeightNames(const HepMC3::GenEvent &event){
+    const std::size_t weights = std::max<std::size_t>(event.weights().size(), 1);
+    if(event.run_info() && event.run_info()->weight_names().size() == weights){
+        return event.run_info()->weight_names();
+    }
+    return defaultWeightNames(weights);
+}
+
+//Adds factor * weights[i] to slot[i] for each weight
+inline void addWeights(double *slot, const double *weights, double factor, std::size_t numberOfWeights){
+    for(std::size_t i = 0; i < numberOfWeights; i++){    //The slots and the weights of the event never overlap, so each slot is loaded and stored once
+        slot[i] += factor * weights[i];
+    }
+}
+
+//A ratio of two sums over the events, like the pure pT over the total pT, for each weight
+class WeightedRatio{
+public:
+    explicit WeightedRatio(std::size_t weights = 0): numerators(weights, 0.0), denominators(weights, 0.0){}
+
+    //Adds the numerator and denominator of one event with its weights. The slots are allocated by the first event if there are none yet.
+    void fill(const std::vector<double> &weights, double numerator, double denominator){
+        if(this->numerators.empty()){
+            this->numerators.assign(weights.size(), 0.0);
+            this->denominators.assign(weights.size(), 0.0);
+        }
+        const std::size_t n = std::min(weights.size(), this->numerators.size());
+        addWeights(this->numerators.data(), weights.data(), numerator, n);
+        addWeights(this->denominators.data(), weights.data(), denominator, n);
+    }
+
+    void merge(const WeightedRatio &other){
+        if(this->numerators.empty()){
+            *this = other;
+            return;
+        }
+        for(std::size_t i = 0; i < this->numerators.size() && i < other.numerators.size(); i++){
+            this->numerators[i] += other.numerators[i];
+            this->denominators[i] += other.denominators[i];
+        }
+    }
+
+    std::size_t weights() const{
+        return this->numerators.size();
+    }
+    double value(std::size_t weight) const{
+        return this->numerators[weight] / this->denominators[weight];
+    }
+
+    std::vector<double> numerators, denominators;    //Per weight
+};
+
+//Histogram with fixed bins, underflow and overflow like a TH1D, with the contents for all weights of a bin next to each other
+class WeightedHistogram{
+public:
+    WeightedHistogram(const std::string &name = "", int bins = 1, double min = 0.0, double max = 1.0, std::size_t weights = 1): _name(name), _bins(bins), _min(min), _max(max), _weights(weights), _contents((bins + 2) * weights, 0.0){}
+
+    //The bin value falls in, 0 for underflow and bins + 1 for overflow
+    int bin(double value) const{
+        if(value < this->_min){
+            return 0;
+        }
+        if(value >= this->_max){
+            return this->_bins + 1;
+        }
+        return 1 + std::min<int>((value - this->_min) / (this->_max - this->_min) * this->_bins, this->_bins - 1);
+    }
+
+    //Adds factor times each weight to the bin of value
+    void fill(double value, const std::vector<double> &weights, double factor = 1.0){
+        this->fillBin(this->bin(value), weights, factor);
+    }
+    void fillBin(int bin, const std::vector<double> &weights, double factor = 1.0){
+        addWeights(&this->_contents[bin * this->_weights], weights.data(), factor, std::min(weights.size(), this->_weights));
+    }
+
+    void merge(const WeightedHistogram &other){
+        for(std::size_t i = 0; i < this->_contents.size() && i < other._contents.size(); i++){
+            this->_contents[i] += other._contents[i];
+        }
+    }
+
+    //Writes one line per bin (including underflow and overflow) with the name, lower edge, upper edge and the contents for each weight
+    void write(std::ostream &stream) const{
+        for(int i = 0; i < this->_bins + 2; i++){
+            const double low = i == 0 ? -INFINITY : this->_min + (this->_max - this->_min) * (i - 1) / this->_bins;
+            const double high = i == this->_bins + 1 ? INFINITY : this->_min + (this->_max - this->_min) * i / this->_bins;
+            stream << this->_name << "\t" << low << "\t" << high;
+            for(std::size_t j = 0; j < this->_weights; j++){
+                stream << "\t" << this->_contents[i * this->_weights + j];
+            }
+            stream << std::endl;
+        }
+    }
+
+    const std::string& name() const{
+        return this->_name;
+    }
+    std::size_t weights() const{
+        return this->_weights;
+    }
+    //(bins + 2) * weights entries, bin by bin
+    std::vector<double>& contents(){
+        return this->_contents;
+    }
+    const std::vector<double>& contents() const{
+        return this->_contents;
+    }
+
+private:
+    std::string _name;
+    int _bins;
+    double _min, _max;
+    std::size_t _weights;
+    std::vector<double> _contents;
+};
+
+//The header line of a table of WeightedHistogram::write lines, with the weight names as the names of the content columns
+inline void writeWeightedHistogramHeader(std::ostream &stream, const std::vector<std::string> &weightNames){
+    stream << "histogram\tlow\thigh";
+    for(const std::string &name: weightNames){
+        stream << "\t" << name;
+    }
+    stream << std::endl;
+}
\ No newline at end of file
@@ -0,0 +1,327 @@
+#pragma once
+
+#include <HepMC3/GenEvent.h>
+#include <HepMC3/GenParticle.h>
+#include <HepMC3/GenVertex.h>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+
+//The templated functions in Darkness.hpp, Decay.hpp and ParticleSort.hpp work on any particle type with these const methods:
+//  int pid(), double energy(), double px(), double py(), double pz(),
+//  std::size_t numberOfParents(), Particle parent(std::size_t i), std::size_t numberOfChildren(), Particle child(std::size_t i)
+//Both handles below are this kind of type, and are cheap to copy, so walking up or down the genealogy doesn't allocate anything.
+
+//Non-owning handle to a HepMC3 particle, which must outlive the handle
+class HepMCParticle{
+public:
+    HepMCParticle(const HepMC3::GenParticle *particle = nullptr): _particle(particle){}
+    HepMCParticle(const HepMC3::ConstGenParticlePtr &particle): _particle(particle.get()){}
+
+    int pid() const{
+        return this->_particle->pid();
+    }
+    int abspid() const{
+        return std::abs(this->_particle->pid());
+    }
+    int status() const{
+        return this->_particle->status();
+    }
+    double energy() const{
+        return this->_particle->momentum().e();
+    }
+    double px() const{
+        return this->_particle->momentum().px();
+    }
+    double py() const{
+        return this->_particle->momentum().py();
+    }
+    double pz() const{
+        return this->_particle->momentum().pz();
+    }
+
+    std::size_t numberOfParents() const{
+        const HepMC3::ConstGenVertexPtr vertex = this->_particle->production_vertex();
+        return vertex ? vertex->particles_in().size() : 0;
+    }
+    HepMCParticle parent(std::size_t i) const{
+        return HepMCParticle(this->_particle->production_vertex()->particles_in()[i].get());
+    }
+    std::size_t numberOfChildren() const{
+        const HepMC3::ConstGenVertexPtr vertex = this->_particle->end_vertex();
+        return vertex ? vertex->particles_out().size() : 0;
+    }
+    HepMCParticle child(std::size_t i) const{
+        return HepMCParticle(this->_particle->end_vertex()->particles_out()[i].get());
+    }
+
+    const HepMC3::GenParticle* genParticle() const{
+        return this->_particle;
+    }
+    bool operator==(const HepMCParticle &other) const{
+        return this->_particle == other._particle;
+    }
+    bool operator!=(const HepMCParticle &other) const{
+        return this->_particle != other._particle;
+    }
+
+private:
+    const HepMC3::GenParticle *_particle;
+};
+
+class FlatParticle;
+
+//Non-owning view of an event stored as flat arrays with one entry per particle. The parents of particle i are parentIndices[parentOffsets[i]], ..., parentIndices[parentOffsets[i + 1] - 1] (compressed sparse rows), and the same for children.
+struct FlatEvent{
+    FlatParticle particle(std::size_t index) const;
+    //All particles with the given status, for example 1 for the final state
+    std::vector<FlatParticle> particlesWithStatus(int status) const;
+
+    std::size_t size = 0;
+    const int *pid = nullptr;
+    const int *status = nullptr;
+    const double *px = nullptr;
+    const double *py = nullptr;
+    const double *pz = nullptr;
+    const double *energy = nullptr;
+    const double *productionTime = nullptr;    //Time component of the production vertex, 0 for particles without one
+    const std::uint32_t *parentOffsets = nullptr;    //size + 1 entries
+    const std::uint32_t *parentIndices = nullptr;
+    const std::uint32_t *childOffsets = nullptr;    //size + 1 entries
+    const std::uint32_t *childIndices = nullptr;
+    std::size_t numberOfWeights = 0;    //The weight variations of the event (GenEvent::weights()), none if the event has no weights
+    const double *weights = nullptr;
+};
+
+//Handle to particle number index of a FlatEvent, which must outlive the handle
+class FlatParticle{
+public:
+    FlatParticle(const FlatEvent *event = nullptr, std::uint32_t index = 0): _event(event), _index(index){}
+
+    int pid() const{
+        return this->_event->pid[this->_index];
+    }
+    int abspid() const{
+        return std::abs(this->_event->pid[this->_index]);
+    }
+    int status() const{
+        return this->_event->status[this->_index];
+    }
+    double energy() const{
+        return this->_event->energy[this->_index];
+    }
+    double px() const{
+        return this->_event->px[this->_index];
+    }
+    double py() const{
+        return this->_event->py[this->_index];
+    }
+    double pz() const{
+        return this->_event->pz[this->_index];
+    }
+    double productionTime() const{
+        return this->_event->productionTime[this->_index];
+    }
+
+    std::size_t numberOfParents() const{
+        return this->_event->parentOffsets[this->_index + 1] - this->_event->parentOffsets[this->_index];
+    }
+    FlatParticle parent(std::size_t i) const{
+        return FlatParticle(this->_event, this->_event->parentIndices[this->_event->parentOffsets[this->_index] + i]);
+    }
+    std::size_t numberOfChildren() const{
+        return this->_event->childOffsets[this->_index + 1] - this->_event->childOffsets[this->_index];
+    }
+    FlatParticle child(std::size_t i) const{
+        return FlatParticle(this->_event, this->_event->childIndices[this->_event->childOffsets[this->_index] + i]);
+    }
+
+    std::uint32_t index() const{
+        return this->_index;
+    }
+    bool operator==(const FlatParticle &other) const{
+        return this->_event == other._event && this->_index == other._index;
+    }
+    bool operator!=(const FlatParticle &other) const{
+        return !(*this == other);
+    }
+
+private:
+    const FlatEvent *_event;
+    std::uint32_t _index;
+};
+
+inline FlatParticle FlatEvent::particle(std::size_t index) const{
+    return FlatParticle(this, index);
+}
+
+inline std::vector<FlatParticle> FlatEvent::particlesWithStatus(int status) const{
+    std::vector<FlatParticle> particles;
+    for(std::size_t i = 0; i < this->size; i++){
+        if(this->status[i] == status){
+            particles.push_back(this->particle(i));
+        }
+    }
+    return particles;
+}
+
+//Owns the arrays of a FlatEvent. The arrays are reused between events, so filling one storage object with each event doesn't allocate once the arrays are large enough.
+class FlatEventStorage{
+public:
+    FlatEventStorage(){
+        this->updateView();
+    }
+    //The view points into this object, so it can't be copied without updating the view
+    FlatEventStorage(const FlatEventStorage &other){
+        *this = other;
+    }
+    FlatEventStorage& operator=(const FlatEventStorage &other){
+        this->_pid = other._pid;
+        this->_status = other._status;
+        this->_px = other._px;
+        this->_py = other._py;
+        this->_pz = other._pz;
+        this->_energy = other._energy;
+        this->_productionTime = other._productionTime;
+        this->_parentOffsets = other._parentOffsets;
+        this->_parentIndices = other._parentIndices;
+        this->_childOffsets = other._childOffsets;
+        this->_childIndices = other._childIndices;
+        this->_weights = other._weights;
+        this->updateView();
+        return *this;
+    }
+
+    //Copies the particles and their genealogy from a HepMC3 event. Particle number i is event.particles()[i], which has the HepMC3 id i + 1.
+    void fill(const HepMC3::GenEvent &event){
+        this->clear();
+        for(const HepMC3::ConstGenParticlePtr &particle: event.particles()){
+            const HepMC3::FourVector &momentum = particle->momentum();
+            this->_pid.push_back(particle->pid());
+            this->_status.push_back(particle->status());
+            this->_px.push_back(momentum.px());
+            this->_py.push_back(momentum.py());
+            this->_pz.push_back(momentum.pz());
+            this->_energy.push_back(momentum.e());
+            this->_productionTime.push_back(0.0);
+            if(const HepMC3::ConstGenVertexPtr vertex = particle->production_vertex()){
+                this->_productionTime.back() = vertex->position().t();
+                for(const HepMC3::ConstGenParticlePtr &parent: vertex->particles_in()){
+                    this->_parentIndices.push_back(parent->id() - 1);
+                }
+            }
+            this->_parentOffsets.push_back(this->_parentIndices.size());
+            if(const HepMC3::ConstGenVertexPtr vertex = particle->end_vertex()){
+                for(const HepMC3::ConstGenParticlePtr &child: vertex->particles_out()){
+                    this->_childIndices.push_back(child->id() - 1);
+                }
+            }
+            this->_childOffsets.push_back(this->_childIndices.size());
+        }
+        this->_weights = event.weights();
+        this->updateView();
+    }
+
+    //Copies the particles, genealogy and weights of another flat event
+    void fill(const FlatEvent &event){
+        this->_pid.assign(event.pid, event.pid + event.size);
+        this->_status.assign(event.status, event.status + event.size);
+        this->_px.assign(event.px, event.px + event.size);
+        this->_py.assign(event.py, event.py + event.size);
+        this->_pz.assign(event.pz, event.pz + event.size);
+        this->_energy.assign(event.energy, event.energy + event.size);
+        this->_productionTime.assign(event.productionTime, event.productionTime + event.size);
+        this->_parentOffsets.assign(event.parentOffsets, event.parentOffsets + event.size + 1);
+        this->_parentIndices.assign(event.parentIndices, event.parentIndices + event.parentOffsets[event.size]);
+        this->_childOffsets.assign(event.childOffsets, event.childOffsets + event.size + 1);
+        this->_childIndices.assign(event.childIndices, event.childIndices + event.childOffsets[event.size]);
+        this->_weights.assign(event.weights, event.weights + event.numberOfWeights);
+        this->updateView();
+    }
+
+    //Appends a copy of particle with other parents and children, given as indices in this storage (the children may be added later)
+    void add(const FlatParticle &particle, const std::vector<std::uint32_t> &parents, const std::vector<std::uint32_t> &children){
+        this->_pid.push_back(particle.pid());
+        this->_status.push_back(particle.status());
+        this->_px.push_back(particle.px());
+        this->_py.push_back(particle.py());
+        this->_pz.push_back(particle.pz());
+        this->_energy.push_back(particle.energy());
+        this->_productionTime.push_back(particle.productionTime());
+        this->_parentIndices.insert(this->_parentIndices.end(), parents.begin(), parents.end());
+        this->_parentOffsets.push_back(this->_parentIndices.size());
+        this->_childIndices.insert(this->_childIndices.end(), children.begin(), children.end());
+        this->_childOffsets.push_back(this->_childIndices.size());
+        this->updateView();
+    }
+
+    //Appends a final state particle without parents or children, like a particle of an overlaid pile-up event
+    void addFinalStateParticle(int pid, double px, double py, double pz, double energy){
+        this->_pid.push_back(pid);
+        this->_status.push_back(1);
+        this->_px.push_back(px);
+        this->_py.push_back(py);
+        this->_pz.push_back(pz);
+        this->_energy.push_back(energy);
+        this->_productionTime.push_back(0.0);
+        this->_parentOffsets.push_back(this->_parentIndices.size());
+        this->_childOffsets.push_back(this->_childIndices.size());
+        this->updateView();
+    }
+
+    void setWeights(const double *weights, std::size_t numberOfWeights){
+        this->_weights.assign(weights, weights + numberOfWeights);
+        this->updateView();
+    }
+
+    void clear(){
+        for(std::vector<double> *column: {&this->_px, &this->_py, &this->_pz, &this->_energy, &this->_productionTime}){
+            column->clear();
+        }
+        this->_pid.clear();
+        this->_status.clear();
+        this->_parentOffsets.assign(1, 0);
+        this->_parentIndices.clear();
+        this->_childOffsets.assign(1, 0);
+        this->_childIndices.clear();
+        this->_weights.clear();
+        this->updateView();
+    }
+
+    const FlatEvent& view() const{
+        return this->_view;
+    }
+    std::size_t size() const{
+        return this->_view.size;
+    }
+    FlatParticle particle(std::size_t index) const{
+        return this->_view.particle(index);
+    }
+    std::vector<FlatParticle> particlesWithStatus(int status) const{
+        return this->_view.particlesWithStatus(status);
+    }
+
+private:
+    void updateView(){
+        this->_view.size = this->_pid.size();
+        this->_view.pid = this->_pid.data();
+        this->_view.status = this->_status.data();
+        this->_view.px = this->_px.data();
+        this->_view.py = this->_py.data();
+        this->_view.pz = this->_pz.data();
+        this->_view.energy = this->_energy.data();
+        this->_view.productionTime = this->_productionTime.data();
+        this->_view.parentOffsets = this->_parentOffsets.data();
+        this->_view.parentIndices = this->_parentIndices.data();
+        this->_view.childOffsets = this->_childOffsets.data();
+        this->_view.childIndices = this->_childIndices.data();
+        this->_view.numberOfWeights = this->_weights.size();
+        this->_view.weights = this->_weights.data();
+    }
+
+    std::vector<int> _pid, _status;
+    std::vector<double> _px, _py, _pz, _energy, _productionTime;
+    std::vector<std::uint32_t> _parentOffsets{0}, _parentIndices, _childOffsets{0}, _childIndices;
+    std::vector<double> _weights;
+    FlatEvent _view;
+};
\ No newline at end of file
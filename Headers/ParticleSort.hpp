@@ -1,23 +1,61 @@
-#pragma once
-
-#include <Rivet/Particle.hh>
-#include <vector>
-#include <map>
-
-template<typename T1, typename T2> std::vector<std::pair<T1, T2>> sortMap(const std::map<T1, T2> &map){
-    std::vector<std::pair<T1, T2>> sortedMap;
-    for(const std::pair<T1, T2> &pair: map){
-        sortedMap.push_back(pair);
-    }
-    std::sort(sortedMap.begin(), sortedMap.end(), [](const std::pair<T1, T2> &a, const std::pair<T1, T2> &b){
-        return a.second > b.second;
-    });
-    return sortedMap;
-}
-
-static Rivet::Particles particlesByEnergy(Rivet::Particles particles){
-    std::sort(particles.begin(), particles.end(), [](const Rivet::Particle &a, const Rivet::Particle &b){
-        return a.energy() > b.energy();    //Reverse the sorting so that the highest energy comes first
-    });
-    return particles;
-}
\ No newline at end of file
+#pragma once
+
+#include <vector>
+#include <map>
+#include <algorithm>
+#include "Timing.hpp"
+
+template<typename T1, typename T2> std::vector<std::pair<T1, T2>> sortMap(const std::map<T1, T2> &map){
+    std::vector<std::pair<T1, T2>> sortedMap;
+    for(const std::pair<T1, T2> &pair: map){
+        sortedMap.push_back(pair);
+    }
+    std::sort(sortedMap.begin(), sortedMap.end(), [](const std::pair<T1, T2> &a, const std::pair<T1, T2> &b){
+        return a.second > b.second;
+    });
+    return sortedMap;
+}
+
+template<typename Particle> std::vector<Particle> particlesByEnergy(std::vector<Particle> particles){
+    std::sort(particles.begin(), particles.end(), [](const Particle &a, const Particle &b){
+        return a.energy() > b.energy();    //Reverse the sorting so that the highest energy comes first
+    });
+    return particles;
+}
+
+//Same as particlesByEnergy(parents)[0] but without making a vector, for particle types with parent(i) (see ParticleHandle.hpp). Of parents with the same energy, the first one is returned. particlesByEnergy uses std::sort, which puts such ties in no fixed order, so the two can differ in that case.
+template<typename Particle> Particle highestEnergyParent(const Particle &particle){
+    Particle parent = particle.parent(0);
+    const std::size_t parents = particle.numberOfParents();
+    for(std::size_t i = 1; i < parents; i++){
+        const Particle candidate = particle.parent(i);
+        if(candidate.energy() > parent.energy()){
+            parent = candidate;
+        }
+    }
+    return parent;
+}
+
+//Checks if parton is particle itself or one of the ancestors found by following the highest-energy parent at each step
+template<typename Particle> bool particleIsFromParton(Particle particle, const Particle &parton){
+    TIME_SCOPE("particleIsFromParton");
+#ifdef DARKJET_TIMING
+    std::size_t depth = 0;
+#endif
+    for(; particle.numberOfParents() > 0; particle = highestEnergyParent(particle)){
+        if(particle == parton){
+            TIMING_RECORD("particleIsFromParton walk depth", depth);
+            return true;
+        }
+#ifdef DARKJET_TIMING
+        depth++;
+#endif
+    }
+    TIMING_RECORD("particleIsFromParton walk depth", depth);
+    return false;
+}
+
+//particlesByEnergy for Rivet particles, whenever Rivet is available
+#if __has_include(<Rivet/Particle.hh>)
+#include "ParticleSortRivet.hpp"
+#endif
\ No newline at end of file
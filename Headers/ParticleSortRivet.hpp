@@ -0,0 +1,14 @@
+#pragma once
+
+#include <Rivet/Particle.hh>
+#include <algorithm>
+#include "ParticleSort.hpp"
+
+//particlesByEnergy for Rivet particles, which returns Rivet::Particles
+
+static Rivet::Particles particlesByEnergy(Rivet::Particles particles){
+    std::sort(particles.begin(), particles.end(), [](const Rivet::Particle &a, const Rivet::Particle &b){
+        return a.energy() > b.energy();    //Reverse the sorting so that the highest energy comes first
+    });
+    return particles;
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <Rivet/Particle.hh>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <cstdlib>
+
+//Maps the PDG IDs seen during a run to dense slots 0, 1, 2, ..., so that per-PDG ID counters can be stored in plain arrays instead of std::maps
+class PdgIdRegistry{
+public:
+    PdgIdRegistry(): _directSlots(2 * _directRange, -1){}
+
+    //Returns the slot of pdgid, assigning a new slot if this is the first time pdgid is seen
+    std::size_t slot(Rivet::PdgId pdgid){
+        if(std::abs(pdgid) < _directRange){
+            int &directSlot = this->_directSlots[pdgid + _directRange];
+            if(directSlot < 0){
+                directSlot = this->_pdgIds.size();
+                this->_pdgIds.push_back(pdgid);
+            }
+            return directSlot;
+        }
+        const auto inserted = this->_otherSlots.insert({pdgid, this->_pdgIds.size()});
+        if(inserted.second){
+            this->_pdgIds.push_back(pdgid);
+        }
+        return inserted.first->second;
+    }
+
+    //Returns the slot of pdgid, or -1 if pdgid hasn't been seen
+    int find(Rivet::PdgId pdgid) const{
+        if(std::abs(pdgid) < _directRange){
+            return this->_directSlots[pdgid + _directRange];
+        }
+        const auto it = this->_otherSlots.find(pdgid);
+        return it == this->_otherSlots.end() ? -1 : it->second;
+    }
+
+    Rivet::PdgId pdgid(std::size_t slot) const{
+        return this->_pdgIds[slot];
+    }
+
+    std::size_t size() const{
+        return this->_pdgIds.size();
+    }
+
+    //Converts an array of counters indexed by slot to a map indexed by PDG ID, for example to pass it to sortMap
+    template<typename T> std::map<Rivet::PdgId, T> toMap(const std::vector<T> &counters) const{
+        std::map<Rivet::PdgId, T> map;
+        for(std::size_t i = 0; i < counters.size() && i < this->_pdgIds.size(); i++){
+            map[this->_pdgIds[i]] = counters[i];
+        }
+        return map;
+    }
+
+private:
+    static constexpr int _directRange = 10000;    //PDG IDs with an absolute value below this (all SM particles) are looked up in a flat array, the rest in a hash map
+    std::vector<int> _directSlots;
+    std::unordered_map<Rivet::PdgId, int> _otherSlots;
+    std::vector<Rivet::PdgId> _pdgIds;
+};
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <random>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <unordered_map>
+#include "EventCache.hpp"
+#include "ParticleHandle.hpp"
+#include "Darkness.hpp"
+#include "GetEnvVars.hpp"
+#include "Timing.hpp"
+
+//Pile-up overlay: the final states of a number of minimum-bias events from a pre-generated pool are added to the final state of each event before it is clustered.
+//The pool is an event cache (see ConvertToEventCache), which is memory-mapped, so drawing an event from it only looks up its offset. The final state particles of each pool event are found once when the pool is opened.
+//Overlaid particles have no genealogy, so they count as neither dark nor from a parton. Dark particles in the pool are left out.
+
+class PileUpPool{
+public:
+    PileUpPool(const std::string &path, double mu): _reader(path), _path(path), _mu(mu), _finalStateOffsets{0}{
+        std::unordered_map<int, bool> dark;    //pdgIdIsDark for each PDG ID in the pool, since it is slow
+        for(std::size_t i = 0; i < this->_reader.size(); i++){
+            const FlatEvent event = this->_reader.event(i);
+            for(std::size_t j = 0; j < event.size; j++){
+                if(event.status[j] == 1){
+                    const auto known = dark.find(event.pid[j]);
+                    const bool isDark = known != dark.end() ? known->second : (dark[event.pid[j]] = pdgIdIsDark(event.pid[j]));
+                    if(!isDark){
+                        this->_finalStateIndices.push_back(j);
+                    }
+                }
+            }
+            this->_finalStateOffsets.push_back(this->_finalStateIndices.size());
+        }
+    }
+
+    //Whether the pool could be opened and has any events
+    bool good() const{
+        return this->_reader.size() > 0;
+    }
+    std::size_t size() const{
+        return this->_reader.size();
+    }
+    const std::string& path() const{
+        return this->_path;
+    }
+    double mu() const{
+        return this->_mu;
+    }
+
+    //The pool events to overlay on the event with id eventId: a Poisson distributed number of them with mean mu, drawn uniformly with replacement.
+    //The generator is seeded from eventId alone, and the number of events and the events themselves are found from its numbers directly with poisson and a modulo, not with the distributions of <random>, whose algorithms differ between standard libraries.
+    std::vector<std::size_t> draw(std::uint64_t eventId) const{
+        std::mt19937_64 generator(eventId * 0x9e3779b97f4a7c15ull + 0x2545f4914f6cdd1dull);
+        std::vector<std::size_t> events(poisson(generator, this->_mu));
+        for(std::size_t &event: events){
+            event = generator() % this->size();    //The bias towards the first events is below size() / 2^64
+        }
+        return events;
+    }
+
+    //Calls add(particle) for each overlaid particle of the event with id eventId, and returns the number of them
+    template<typename Add> std::size_t overlay(std::uint64_t eventId, Add add) const{
+        std::size_t particles = 0;
+        for(const std::size_t i: this->draw(eventId)){
+            const FlatEvent event = this->_reader.event(i);
+            for(std::uint32_t j = this->_finalStateOffsets[i]; j < this->_finalStateOffsets[i + 1]; j++){
+                add(event.particle(this->_finalStateIndices[j]));
+            }
+            particles += this->_finalStateOffsets[i + 1] - this->_finalStateOffsets[i];
+        }
+        return particles;
+    }
+
+private:
+    //A Poisson distributed number with mean mu, by inverting the cumulative distribution with a uniform number in [0, 1) from the top 53 bits of a number of generator. Means above maxMean are split into parts of at most maxMean, whose numbers add up, so that exp(-mean) stays far from 0.
+    static std::size_t poisson(std::mt19937_64 &generator, double mu){
+        static constexpr double maxMean = 500.0;
+        std::size_t number = 0;
+        for(double remaining = mu; remaining > 0.0; remaining -= maxMean){
+            const double mean = std::min(remaining, maxMean);
+            const double uniform = (generator() >> 11) * 0x1.0p-53;
+            double probability = std::exp(-mean), cumulative = probability;    //Of k
+            for(std::size_t k = 1; uniform >= cumulative && probability > 0.0; k++){    //probability reaches 0 if rounding keeps cumulative below uniform
+                probability *= mean / k;
+                cumulative += probability;
+                number++;
+            }
+        }
+        return number;
+    }
+
+    EventCacheReader _reader;
+    const std::string _path;
+    const double _mu;
+    std::vector<std::uint32_t> _finalStateOffsets, _finalStateIndices;    //The final state particles that are overlaid of pool event i are _finalStateIndices[_finalStateOffsets[i]], ..., _finalStateIndices[_finalStateOffsets[i + 1] - 1]
+};
+
+//The pool in PILEUP_FILE with the mean number of overlaid events PILEUP_MU, or null if PILEUP_MU isn't above 0 or the pool can't be used
+inline std::shared_ptr<const PileUpPool> pileUpPoolFromEnvVars(){
+    const double mu = getDoubleFromEnvVar("PILEUP_MU", 0.0);
+    if(mu <= 0.0){
+        return nullptr;
+    }
+    const std::string path = getStringFromEnvVar("PILEUP_FILE", std::string("../Outputs/MinimumBias.djc"));
+    const std::shared_ptr<const PileUpPool> pool = std::make_shared<const PileUpPool>(path, mu);
+    if(!pool->good()){
+        std::cout << "Warning: the pile-up pool " << path << " has no events, so no pile-up is overlaid." << std::endl;
+        return nullptr;
+    }
+    return pool;
+}
+
+//Copies event to overlaid and appends the overlaid particles of the event with id eventId as final state particles without parents
+inline void overlayPileUp(const FlatEvent &event, const PileUpPool &pool, std::uint64_t eventId, FlatEventStorage &overlaid){
+    TIME_SCOPE("pile-up overlay");
+    overlaid.fill(event);
+    [[maybe_unused]] const std::size_t particles = pool.overlay(eventId, [&overlaid](const FlatParticle &particle){
+        overlaid.addFinalStateParticle(particle.pid(), particle.px(), particle.py(), particle.pz(), particle.energy());
+    });
+    TIMING_COUNT("pile-up particles", particles);
+}
\ No newline at end of file
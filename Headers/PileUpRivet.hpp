@@ -0,0 +1,19 @@
+#pragma once
+
+#include <Rivet/Particle.hh>
+#include <vector>
+#include "PileUp.hpp"
+#include "JetClusteringRivet.hpp"
+
+//The pile-up overlay of PileUp.hpp for Rivet analyses, whose FastJets projections can only cluster particles of the event, so the overlaid particles are clustered with clusterParticles (see JetClusteringRivet.hpp)
+
+//The overlaid particles of the event with id eventId as Rivet particles, which have no GenParticle
+inline Rivet::Particles pileUpParticles(const PileUpPool &pool, std::uint64_t eventId){
+    TIME_SCOPE("pile-up overlay");
+    Rivet::Particles particles;
+    pool.overlay(eventId, [&particles](const FlatParticle &particle){
+        particles.push_back(Rivet::Particle(particle.pid(), Rivet::FourMomentum(particle.energy(), particle.px(), particle.py(), particle.pz())));
+    });
+    TIMING_COUNT("pile-up particles", particles.size());
+    return particles;
+}
\ No newline at end of file
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include "ParticleHandle.hpp"
+#include "GetEnvVars.hpp"
+
+//Truth-level cuts that run on the genealogy of an event before the jets are clustered, so that the events the analyses can't use or aren't interested in are rejected before the expensive part.
+//The cuts are a list that is applied in order until one fails, and a Cutflow counts how many events pass each cut and how long each cut takes.
+
+//Finds the resonance like PartonTruthEfficiency: the first particle with a PDG ID in resonancePdgIds, with PLOT_SECOND_CHILDREN=2 its first ancestor with another PDG ID, and then the last of its copies, whose children are the decay products
+inline bool findResonance(const FlatEvent &event, const std::vector<int> &resonancePdgIds, int plotSecondChildren, FlatParticle &resonance){
+    bool found = false;
+    for(std::size_t i = 0; i < event.size && !found; i++){
+        resonance = event.particle(i);
+        found = std::find(resonancePdgIds.begin(), resonancePdgIds.end(), resonance.pid()) != resonancePdgIds.end();
+    }
+    if(!found){
+        return false;
+    }
+    if(plotSecondChildren == 2){
+        const int previousPdgId = resonance.pid();
+        while(resonance.pid() == previousPdgId && resonance.numberOfParents() > 0){
+            resonance = resonance.parent(0);
+        }
+    }
+    while(resonance.numberOfChildren() == 1){
+        resonance = resonance.child(0);
+    }
+    return true;
+}
+
+//The number of events that reached and passed each cut of a PreSelection, and the time spent in each cut. Cutflows filled separately are merged by adding them up.
+class Cutflow{
+public:
+    Cutflow(): events(0){}
+
+    void merge(const Cutflow &other){
+        this->events += other.events;
+        this->passed.resize(std::max(this->passed.size(), other.passed.size()), 0);
+        this->seconds.resize(this->passed.size(), 0.0);
+        for(std::size_t i = 0; i < other.passed.size(); i++){
+            this->passed[i] += other.passed[i];
+            this->seconds[i] += other.seconds[i];
+        }
+    }
+
+    long events;
+    std::vector<long> passed;    //Per cut
+    std::vector<double> seconds;    //Per cut
+};
+
+class PreSelection{
+public:
+    //The resonance cut is always applied, the others only if their environment variable is set
+    PreSelection(const std::vector<int> &resonancePdgIds, int plotSecondChildren):
+        decayPdgIds(getIntVectorFromEnvVar("PRESELECT_DECAY", std::vector<int>{})),
+        minPartonPT(getDoubleFromEnvVar("PRESELECT_MIN_PARTON_PT", 0.0)),
+        minMultiplicity(getIntFromEnvVar("PRESELECT_MIN_MULTIPLICITY", 0)),
+        _resonancePdgIds(resonancePdgIds),
+        _plotSecondChildren(plotSecondChildren)
+    {
+        this->_cuts.push_back(Cut{"resonance found", &PreSelection::resonanceFound});
+        if(!this->decayPdgIds.empty()){
+            this->_cuts.push_back(Cut{"decay mode", &PreSelection::decayMode});
+        }
+        if(this->minPartonPT > 0.0){
+            this->_cuts.push_back(Cut{"parton pT", &PreSelection::partonPT});
+        }
+        if(this->minMultiplicity > 0){
+            this->_cuts.push_back(Cut{"final state multiplicity", &PreSelection::finalStateMultiplicity});
+        }
+    }
+
+    //Applies the cuts in order until one fails, and returns the number of cuts the event passed, which is cuts() if it passed all of them. The first cut finds the resonance, so resonance is set if this is more than 0.
+    std::size_t apply(const FlatEvent &event, Cutflow &cutflow, FlatParticle &resonance) const{
+        cutflow.passed.resize(std::max(cutflow.passed.size(), this->_cuts.size()), 0);
+        cutflow.seconds.resize(cutflow.passed.size(), 0.0);
+        cutflow.events++;
+        for(std::size_t i = 0; i < this->_cuts.size(); i++){
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            const bool passed = (this->*this->_cuts[i].pass)(event, resonance);
+            cutflow.seconds[i] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if(!passed){
+                return i;
+            }
+            cutflow.passed[i]++;
+        }
+        return this->_cuts.size();
+    }
+
+    std::size_t cuts() const{
+        return this->_cuts.size();
+    }
+
+    //Prints the number of events after each cut, the fraction of the events that reached the cut, and the average time of the cut
+    void printCutflow(const Cutflow &cutflow) const{
+        std::cout << "Pre-selection cutflow:" << std::endl << "All events: " << cutflow.events << std::endl;
+        long reached = cutflow.events;
+        for(std::size_t i = 0; i < this->_cuts.size() && i < cutflow.passed.size(); i++){
+            const double perEvent = reached > 0 ? 1.0 / reached : 0.0;
+            std::cout << this->_cuts[i].name << ": " << cutflow.passed[i] << " (" << (100.0 * cutflow.passed[i] * perEvent) << "%), " << (1e6 * cutflow.seconds[i] * perEvent) << " us per event" << std::endl;
+            reached = cutflow.passed[i];
+        }
+    }
+
+    std::vector<int> decayPdgIds;    //The decay products of the resonance must all have one of these absolute PDG IDs
+    double minPartonPT;    //In GeV, for all decay products of the resonance
+    int minMultiplicity;    //Of the final state
+
+private:
+    struct Cut{
+        std::string name;
+        bool (PreSelection::*pass)(const FlatEvent &event, FlatParticle &resonance) const;
+    };
+
+    bool resonanceFound(const FlatEvent &event, FlatParticle &resonance) const{
+        return findResonance(event, this->_resonancePdgIds, this->_plotSecondChildren, resonance);
+    }
+    bool decayMode(const FlatEvent&, FlatParticle &resonance) const{
+        for(std::size_t i = 0; i < resonance.numberOfChildren(); i++){
+            if(std::find(this->decayPdgIds.begin(), this->decayPdgIds.end(), resonance.child(i).abspid()) == this->decayPdgIds.end()){
+                return false;
+            }
+        }
+        return resonance.numberOfChildren() > 0;
+    }
+    bool partonPT(const FlatEvent&, FlatParticle &resonance) const{
+        for(std::size_t i = 0; i < resonance.numberOfChildren(); i++){
+            const FlatParticle child = resonance.child(i);
+            if(std::hypot(child.px(), child.py()) < this->minPartonPT){
+                return false;
+            }
+        }
+        return true;
+    }
+    bool finalStateMultiplicity(const FlatEvent &event, FlatParticle&) const{
+        return std::count(event.status, event.status + event.size, 1) >= this->minMultiplicity;
+    }
+
+    std::vector<int> _resonancePdgIds;
+    int _plotSecondChildren;
+    std::vector<Cut> _cuts;
+};
\ No newline at end of file
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <utility>
+#include <cmath>
+#include <algorithm>
+
+//Streaming quantiles with a merging t-digest: the values are kept as at most about compression centroids (a mean and a weight each), which are small near the lowest and highest values and large in the middle, so the median, the quartiles and the tails are all found to a small fraction of a percent in quantile without storing the values or choosing a range.
+//Digests are merged by adding the centroids of one to the other, so each thread or shard can fill its own. The result is approximate, and only depends on the order of the fills and merges, which the analyses keep in event order.
+
+class QuantileSketch{
+public:
+    explicit QuantileSketch(double compression = 100.0): _compression(compression), _totalWeight(0.0), _minimum(INFINITY), _maximum(-INFINITY){}
+
+    void fill(double value, double weight = 1.0){
+        if(!std::isfinite(value) || !(weight > 0)){
+            return;
+        }
+        this->_buffer.push_back({value, weight});
+        this->_totalWeight += weight;
+        this->_minimum = std::min(this->_minimum, value);
+        this->_maximum = std::max(this->_maximum, value);
+        if(this->_buffer.size() >= this->bufferSize()){
+            this->compress();
+        }
+    }
+
+    void merge(const QuantileSketch &other){
+        if(other.empty()){
+            return;
+        }
+        this->_buffer.insert(this->_buffer.end(), other._centroids.begin(), other._centroids.end());
+        this->_buffer.insert(this->_buffer.end(), other._buffer.begin(), other._buffer.end());
+        this->_totalWeight += other._totalWeight;
+        this->_minimum = std::min(this->_minimum, other._minimum);
+        this->_maximum = std::max(this->_maximum, other._maximum);
+        if(this->_buffer.size() >= this->bufferSize()){
+            this->compress();
+        }
+    }
+
+    //Merges the buffered values into the centroids, from the lowest to the highest mean, as long as each centroid stays within one unit of the scale function k(q) = compression / (2 pi) * asin(2q - 1)
+    void compress(){
+        if(this->_buffer.empty()){
+            return;
+        }
+        this->_buffer.insert(this->_buffer.end(), this->_centroids.begin(), this->_centroids.end());
+        std::sort(this->_buffer.begin(), this->_buffer.end());
+        this->_centroids.clear();
+        std::pair<double, double> current = this->_buffer[0];
+        double weightBefore = 0.0;
+        double weightLimit = this->_totalWeight * this->quantileLimit(0.0);
+        for(std::size_t i = 1; i < this->_buffer.size(); i++){
+            const std::pair<double, double> &next = this->_buffer[i];
+            if(weightBefore + current.second + next.second <= weightLimit){
+                current.second += next.second;
+                current.first += (next.first - current.first) * next.second / current.second;
+            }
+            else{
+                this->_centroids.push_back(current);
+                weightBefore += current.second;
+                weightLimit = this->_totalWeight * this->quantileLimit(weightBefore / this->_totalWeight);
+                current = next;
+            }
+        }
+        this->_centroids.push_back(current);
+        this->_buffer.clear();
+    }
+
+    //The value below which a fraction q of the weight lies, interpolating linearly between the centres of the centroids and towards the lowest and highest values at the ends. NaN if nothing was filled.
+    double quantile(double q) const{
+        if(this->empty()){
+            return NAN;
+        }
+        if(!this->_buffer.empty()){
+            QuantileSketch compressed = *this;
+            compressed.compress();
+            return compressed.quantile(q);
+        }
+        const std::vector<std::pair<double, double>> &centroids = this->_centroids;
+        const double index = std::min(std::max(q, 0.0), 1.0) * this->_totalWeight;
+        if(centroids.size() == 1){
+            return this->_minimum + (this->_maximum - this->_minimum) * index / this->_totalWeight;
+        }
+        const std::pair<double, double> &first = centroids.front(), &last = centroids.back();
+        if(index < first.second / 2){
+            return this->_minimum + (first.first - this->_minimum) * index / (first.second / 2);
+        }
+        if(index > this->_totalWeight - last.second / 2){
+            return this->_maximum - (this->_maximum - last.first) * (this->_totalWeight - index) / (last.second / 2);
+        }
+        double weightSoFar = first.second / 2;
+        for(std::size_t i = 0; i + 1 < centroids.size(); i++){
+            const double distance = (centroids[i].second + centroids[i + 1].second) / 2;
+            if(weightSoFar + distance >= index){
+                return centroids[i].first + (centroids[i + 1].first - centroids[i].first) * (index - weightSoFar) / distance;
+            }
+            weightSoFar += distance;
+        }
+        return last.first;
+    }
+    double median() const{
+        return this->quantile(0.5);
+    }
+    double interquartileRange() const{
+        return this->quantile(0.75) - this->quantile(0.25);
+    }
+
+    bool empty() const{
+        return this->_totalWeight == 0.0;
+    }
+    double totalWeight() const{
+        return this->_totalWeight;
+    }
+    double minimum() const{
+        return this->_minimum;
+    }
+    double maximum() const{
+        return this->_maximum;
+    }
+
+    //Writes the compressed centroids with a CheckpointWriter or anything else with the same write methods
+    template<typename Writer> void write(Writer &writer) const{
+        QuantileSketch compressed = *this;
+        compressed.compress();
+        std::vector<double> means, weights;
+        for(const std::pair<double, double> &centroid: compressed._centroids){
+            means.push_back(centroid.first);
+            weights.push_back(centroid.second);
+        }
+        writer.write(means);
+        writer.write(weights);
+        writer.write(this->_totalWeight);
+        writer.write(this->_minimum);
+        writer.write(this->_maximum);
+    }
+    //Reads what write wrote with a CheckpointReader
+    template<typename Reader> void read(Reader &reader){
+        std::vector<double> means, weights;
+        reader.read(means);
+        reader.read(weights);
+        reader.read(this->_totalWeight);
+        reader.read(this->_minimum);
+        reader.read(this->_maximum);
+        this->_centroids.clear();
+        this->_buffer.clear();
+        for(std::size_t i = 0; i < means.size() && i < weights.size(); i++){
+            this->_centroids.push_back({means[i], weights[i]});
+        }
+    }
+
+private:
+    //The buffer is merged into the centroids when it has this many entries, so that sorting it is spread over many fills
+    std::size_t bufferSize() const{
+        return 5 * this->_compression;
+    }
+
+    //The highest quantile that a centroid starting at quantile q may reach, one unit of k further
+    double quantileLimit(double q) const{
+        const double k = this->_compression / (2 * M_PI) * std::asin(2 * q - 1) + 1;
+        return k >= this->_compression / 4 ? 1.0 : (std::sin(k * 2 * M_PI / this->_compression) + 1) / 2;
+    }
+
+    double _compression;
+    std::vector<std::pair<double, double>> _centroids, _buffer;    //Mean and weight, the centroids sorted by mean
+    double _totalWeight;
+    double _minimum, _maximum;
+};
+
+//"median m, IQR r, p1%: x1, p2%: x2, ..." with the values multiplied by scale and followed by unit, for the finalize output of the analyses
+inline std::string quantileText(const QuantileSketch &sketch, const std::vector<int> &percentiles, double scale = 1.0, const std::string &unit = ""){
+    std::ostringstream text;
+    text << "median " << scale * sketch.median() << unit << ", IQR " << scale * sketch.interquartileRange() << unit;
+    for(const int percentile: percentiles){
+        text << ", " << percentile << "%: " << scale * sketch.quantile(percentile / 100.0) << unit;
+    }
+    return text.str();
+}
\ No newline at end of file
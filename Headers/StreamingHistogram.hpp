@@ -0,0 +1,147 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+//Histogram of positive values over [0, 2^n) with a fixed, even number of bins. When a value doesn't fit, n is increased and pairs of neighbouring bins are merged, so no values need to be stored to choose the range.
+//Since the bin edges of two such histograms always line up, merging them is exact.
+class StreamingHistogram{
+public:
+    explicit StreamingHistogram(int bins = 50): _contents(bins + bins % 2, 0.0), _exponent(0), _empty(true), _maximum(0.0), _entries(0), _underflow(0.0){}
+
+    void fill(double value, double weight = 1.0){
+        if(!(value > 0) || !std::isfinite(value)){
+            this->_underflow += weight;
+            return;
+        }
+        const int exponent = std::ilogb(value) + 1;    //value < 2^exponent
+        if(this->_empty){
+            this->_exponent = exponent;
+            this->_empty = false;
+        }
+        else if(exponent > this->_exponent){
+            this->rebin(exponent);
+        }
+        this->_contents[this->bin(value)] += weight;
+        this->_maximum = std::max(this->_maximum, value);
+        this->_entries++;
+    }
+
+    void merge(const StreamingHistogram &other){
+        if(other._empty){
+            this->_underflow += other._underflow;
+            return;
+        }
+        if(this->_empty){
+            const double underflow = this->_underflow;
+            *this = other;
+            this->_underflow += underflow;
+            return;
+        }
+        StreamingHistogram rebinnedOther = other;
+        if(rebinnedOther._exponent < this->_exponent){
+            rebinnedOther.rebin(this->_exponent);
+        }
+        else if(this->_exponent < rebinnedOther._exponent){
+            this->rebin(rebinnedOther._exponent);
+        }
+        for(std::size_t i = 0; i < this->_contents.size(); i++){
+            this->_contents[i] += rebinnedOther._contents[i];
+        }
+        this->_maximum = std::max(this->_maximum, other._maximum);
+        this->_entries += other._entries;
+        this->_underflow += other._underflow;
+    }
+
+    int bins() const{
+        return this->_contents.size();
+    }
+    double binContent(int bin) const{
+        return this->_contents[bin];
+    }
+    double range() const{
+        return this->_empty ? 0.0 : std::ldexp(1.0, this->_exponent);
+    }
+    //The bins up to the one with the largest value. Since the largest value is above half the range, these are at least half of the bins.
+    int usedBins() const{
+        return this->_empty ? 0 : this->bin(this->_maximum) + 1;
+    }
+    double maximum() const{
+        return this->_maximum;
+    }
+    long entries() const{
+        return this->_entries;
+    }
+    double underflow() const{
+        return this->_underflow;
+    }
+
+private:
+    int bin(double value) const{
+        return std::min<int>(std::ldexp(value, -this->_exponent) * this->_contents.size(), this->_contents.size() - 1);
+    }
+
+    //Doubles the range until it is 2^exponent, merging pairs of bins each time
+    void rebin(int exponent){
+        const std::size_t bins = this->_contents.size();
+        for(; this->_exponent < exponent; this->_exponent++){
+            for(std::size_t i = 0; i < bins / 2; i++){
+                this->_contents[i] = this->_contents[2 * i] + this->_contents[2 * i + 1];
+            }
+            std::fill(this->_contents.begin() + bins / 2, this->_contents.end(), 0.0);
+        }
+    }
+
+    std::vector<double> _contents;
+    int _exponent;
+    bool _empty;
+    double _maximum;
+    long _entries;
+    double _underflow;    //Values that are not positive
+};
+
+//Running mean and variance using Welford's algorithm, with exact merging of partial results
+class RunningStatistics{
+public:
+    RunningStatistics(): _count(0), _mean(0.0), _m2(0.0){}
+
+    void fill(double value){
+        this->_count++;
+        const double delta = value - this->_mean;
+        this->_mean += delta / this->_count;
+        this->_m2 += delta * (value - this->_mean);
+    }
+
+    void merge(const RunningStatistics &other){
+        if(other._count == 0){
+            return;
+        }
+        const long count = this->_count + other._count;
+        const double delta = other._mean - this->_mean;
+        this->_mean += delta * other._count / count;
+        this->_m2 += other._m2 + delta * delta * this->_count * other._count / count;
+        this->_count = count;
+    }
+
+    long count() const{
+        return this->_count;
+    }
+    double mean() const{
+        return this->_mean;
+    }
+    double variance() const{
+        return this->_count > 1 ? this->_m2 / (this->_count - 1) : 0.0;
+    }
+    double standardDeviation() const{
+        return std::sqrt(this->variance());
+    }
+    double standardError() const{
+        return this->_count > 0 ? std::sqrt(this->variance() / this->_count) : 0.0;
+    }
+
+private:
+    long _count;
+    double _mean;
+    double _m2;    //Sum of squared differences from the mean
+};
\ No newline at end of file
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <fastjet/PseudoJet.hh>
+#include <fastjet/JetDefinition.hh>
+#include <fastjet/ClusterSequence.hh>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include "JetComposition.hpp"
+#include "QuantileSketch.hpp"
+#include "Timing.hpp"
+
+//Jet substructure observables that tell dark jets from QCD jets: N-subjettiness, energy correlation functions, girth, pT dispersion and constituent multiplicity, together with the darkness of the jet.
+//The constituents of a jet are copied once into contiguous arrays of pT, rapidity and phi, padded with particles of zero pT to a multiple of substructureBlock, and every observable is a sum over those arrays or over the matrix of pairwise angular distances, which is filled once per jet and shared by the energy correlation functions.
+//The kernels are branch-free loops over blocks of substructureBlock entries: the block length is known, so no remainder loop is needed, and each kernel keeps substructureBlock partial sums that are only added up after the last block. The padding adds nothing to the sums.
+
+static constexpr std::size_t substructureBlock = 8;    //Enough doubles for the widest vector registers
+
+//out[i] = DeltaR^2 between (rapidity, phi) and (rapidities[i], phis[i]), with all phis in [0, 2 pi). n must be a multiple of substructureBlock, like for the other kernels.
+inline void deltaRSquared(double rapidity, double phi, const double *__restrict rapidities, const double *__restrict phis, double *__restrict out, std::size_t n){
+    for(std::size_t block = 0; block < n; block += substructureBlock){
+        for(std::size_t i = block; i < block + substructureBlock; i++){
+            const double deltaRapidity = rapidities[i] - rapidity;
+            const double deltaPhi = std::abs(phis[i] - phi);
+            const double wrappedDeltaPhi = std::min(deltaPhi, 2 * M_PI - deltaPhi);
+            out[i] = deltaRapidity * deltaRapidity + wrappedDeltaPhi * wrappedDeltaPhi;
+        }
+    }
+}
+
+//Turns DeltaR^2 into DeltaR^beta in place. The choice of function is made once per call, so that each loop is a plain kernel like the others.
+inline void angularExponent(double *__restrict values, std::size_t n, double beta){
+    if(beta == 2.0){
+        return;
+    }
+    if(beta == 1.0){
+        for(std::size_t block = 0; block < n; block += substructureBlock){
+            for(std::size_t i = block; i < block + substructureBlock; i++){
+                values[i] = std::sqrt(values[i]);
+            }
+        }
+        return;
+    }
+    const double exponent = beta / 2;
+    for(std::size_t block = 0; block < n; block += substructureBlock){
+        for(std::size_t i = block; i < block + substructureBlock; i++){
+            values[i] = std::pow(values[i], exponent);
+        }
+    }
+}
+
+//a[i] = min(a[i], b[i])
+inline void elementwiseMinimum(double *__restrict a, const double *__restrict b, std::size_t n){
+    for(std::size_t block = 0; block < n; block += substructureBlock){
+        for(std::size_t i = block; i < block + substructureBlock; i++){
+            a[i] = std::min(a[i], b[i]);
+        }
+    }
+}
+
+//Sum of a[i] * b[i]
+inline double dotProduct(const double *__restrict a, const double *__restrict b, std::size_t n){
+    double lanes[substructureBlock] = {};
+    for(std::size_t block = 0; block < n; block += substructureBlock){
+        for(std::size_t i = 0; i < substructureBlock; i++){
+            lanes[i] += a[block + i] * b[block + i];
+        }
+    }
+    return std::accumulate(lanes, lanes + substructureBlock, 0.0);
+}
+
+//Sum of a[i] * b[i] * c[i]
+inline double tripleProduct(const double *__restrict a, const double *__restrict b, const double *__restrict c, std::size_t n){
+    double lanes[substructureBlock] = {};
+    for(std::size_t block = 0; block < n; block += substructureBlock){
+        for(std::size_t i = 0; i < substructureBlock; i++){
+            lanes[i] += a[block + i] * b[block + i] * c[block + i];
+        }
+    }
+    return std::accumulate(lanes, lanes + substructureBlock, 0.0);
+}
+
+//The observables of one jet. All angles are DeltaR in rapidity and phi.
+struct JetSubstructure{
+    int multiplicity = 0;
+    double girth = 0.0;           //Sum of pT_i DeltaR_i to the jet axis, over the jet pT
+    double pTDispersion = 0.0;    //sqrt(sum of pT_i^2) over the sum of pT_i
+    double tau1 = 0.0, tau2 = 0.0, tau3 = 0.0;    //N-subjettiness with the exclusive kt axes, normalised by the sum of pT_i R^beta
+    double e2 = 0.0, e3 = 0.0;    //Energy correlation functions with the pT fractions z_i: e2 = sum over pairs of z_i z_j DeltaR_ij^beta, e3 = sum over triplets of z_i z_j z_k (DeltaR_ij DeltaR_ik DeltaR_jk)^beta
+    double pTDarkness = 0.0, pTInvisibility = 0.0;    //From the composition of the jet, or set by the caller for jets without one
+
+    //The ratios are NaN for jets that are too small for them, like jets with one constituent, which the quantile sketches leave out
+
+    double tau21() const{
+        return this->tau1 > 0 ? this->tau2 / this->tau1 : NAN;
+    }
+    double tau32() const{
+        return this->tau2 > 0 ? this->tau3 / this->tau2 : NAN;
+    }
+    double c2() const{
+        return this->e2 > 0 ? this->e3 / (this->e2 * this->e2) : NAN;
+    }
+    double d2() const{
+        return this->e2 > 0 ? this->e3 / (this->e2 * this->e2 * this->e2) : NAN;
+    }
+};
+
+//Computes JetSubstructure for jets of radius R with the angular exponent beta. The arrays are reused between jets, so one calculator should be kept per thread.
+class SubstructureCalculator{
+public:
+    explicit SubstructureCalculator(double radius, double beta = 1.0): _radius(radius), _beta(beta){}
+
+    //The jet must have constituents, like a jet from a ClusterSequence that still exists (for a Rivet jet, its pseudojet()). The darkness and invisibility are taken from composition, or can be set by the caller afterwards.
+    JetSubstructure compute(const fastjet::PseudoJet &jet, const JetComposition &composition = JetComposition()){
+        TIME_SCOPE("substructure");
+        const std::vector<fastjet::PseudoJet> constituents = jet.constituents();
+        JetSubstructure result;
+        result.pTDarkness = composition.pTDarkness();
+        result.pTInvisibility = composition.pTInvisibility();
+        result.multiplicity = constituents.size();
+        if(constituents.empty()){
+            return result;
+        }
+        this->load(constituents);
+        const std::size_t n = this->_pT.size();
+        const double *pT = this->_pT.data(), *rapidity = this->_rapidity.data(), *phi = this->_phi.data();
+        double *distances = this->_distances.data(), *minimumDistances = this->_minimumDistances.data();
+
+        //Girth and pT dispersion, from the distances to the jet axis
+        const double sumPT = std::accumulate(this->_pT.begin(), this->_pT.end(), 0.0);
+        deltaRSquared(jet.rap(), jet.phi(), rapidity, phi, distances, n);
+        angularExponent(distances, n, 1.0);
+        result.girth = jet.pt() > 0 ? dotProduct(pT, distances, n) / jet.pt() : 0.0;
+        result.pTDispersion = std::sqrt(dotProduct(pT, pT, n)) / sumPT;
+
+        //N-subjettiness, with the axes of N = 1, 2 and 3 from one kt clustering of the constituents
+        const double normalisation = sumPT * std::pow(this->_radius, this->_beta);
+        const fastjet::ClusterSequence axesSequence(constituents, fastjet::JetDefinition(fastjet::kt_algorithm, fastjet::JetDefinition::max_allowable_R));
+        double *taus[3] = {&result.tau1, &result.tau2, &result.tau3};
+        for(int axes = 1; axes <= 3 && axes <= result.multiplicity; axes++){
+            const std::vector<fastjet::PseudoJet> axisJets = axesSequence.exclusive_jets(axes);
+            std::fill(minimumDistances, minimumDistances + n, INFINITY);
+            for(const fastjet::PseudoJet &axis: axisJets){
+                deltaRSquared(axis.rap(), axis.phi(), rapidity, phi, distances, n);
+                elementwiseMinimum(minimumDistances, distances, n);
+            }
+            angularExponent(minimumDistances, n, this->_beta);
+            *taus[axes - 1] = dotProduct(pT, minimumDistances, n) / normalisation;
+        }
+
+        //Energy correlation functions from the matrix of pairwise distances, which is filled once and shared by e2 and e3. Its diagonal is 0, so the sums over all indices only count distinct pairs and triplets.
+        const std::size_t m = result.multiplicity;
+        this->_matrix.resize(m * n);
+        double *matrix = this->_matrix.data(), *z = this->_z.data();
+        for(std::size_t i = 0; i < n; i++){
+            z[i] = pT[i] / sumPT;
+        }
+        for(std::size_t i = 0; i < m; i++){
+            deltaRSquared(rapidity[i], phi[i], rapidity, phi, matrix + i * n, n);
+            angularExponent(matrix + i * n, n, this->_beta);
+        }
+        double e2 = 0.0, e3 = 0.0;
+        for(std::size_t i = 0; i < m; i++){
+            const double *row = matrix + i * n;
+            e2 += z[i] * dotProduct(z, row, n);
+            for(std::size_t j = i + 1; j < m; j++){
+                e3 += z[i] * z[j] * row[j] * tripleProduct(z, row, matrix + j * n, n);
+            }
+        }
+        result.e2 = e2 / 2;    //Each pair was counted twice
+        result.e3 = e3 / 3;    //Each triplet was counted once for each of its pairs
+        return result;
+    }
+
+private:
+    //Copies the pT, rapidity and phi of the constituents into the arrays, padded with zero pT to a multiple of substructureBlock
+    void load(const std::vector<fastjet::PseudoJet> &constituents){
+        const std::size_t n = (constituents.size() + substructureBlock - 1) / substructureBlock * substructureBlock;
+        this->_pT.assign(n, 0.0);
+        this->_rapidity.assign(n, 0.0);
+        this->_phi.assign(n, 0.0);
+        for(std::size_t i = 0; i < constituents.size(); i++){
+            this->_pT[i] = constituents[i].pt();
+            this->_rapidity[i] = constituents[i].rap();
+            this->_phi[i] = constituents[i].phi();
+        }
+        this->_distances.resize(n);
+        this->_minimumDistances.resize(n);
+        this->_z.resize(n);
+    }
+
+    const double _radius, _beta;
+    std::vector<double> _pT, _rapidity, _phi, _distances, _minimumDistances, _z, _matrix;    //_matrix has a row of n distances for each constituent
+};
+
+//Quantile sketches of the observables of dark jets (pT darkness above 0.5) and of the other jets, which can be merged like the other sketches and written to a checkpoint
+class SubstructureSummary{
+public:
+    SubstructureSummary(): _sketches(2 * observableNames().size()){}
+
+    static const std::vector<std::string>& observableNames(){
+        static const std::vector<std::string> names{"Multiplicity", "Girth", "PTDispersion", "Tau21", "Tau32", "C2", "D2"};
+        return names;
+    }
+
+    void fill(const JetSubstructure &jet, double weight = 1.0){
+        const double values[] = {1.0 * jet.multiplicity, jet.girth, jet.pTDispersion, jet.tau21(), jet.tau32(), jet.c2(), jet.d2()};
+        const std::size_t offset = jet.pTDarkness > 0.5 ? 0 : observableNames().size();
+        for(std::size_t i = 0; i < observableNames().size(); i++){
+            this->_sketches[offset + i].fill(values[i], weight);
+        }
+    }
+
+    void merge(const SubstructureSummary &other){
+        for(std::size_t i = 0; i < this->_sketches.size(); i++){
+            this->_sketches[i].merge(other._sketches[i]);
+        }
+    }
+
+    //Prints "DarkJet<observable>: ..." and "OtherJet<observable>: ..." lines with quantileText
+    void print(const std::vector<int> &percentiles) const{
+        const std::size_t observables = observableNames().size();
+        for(std::size_t i = 0; i < this->_sketches.size(); i++){
+            std::cout << (i < observables ? "DarkJet" : "OtherJet") << observableNames()[i % observables] << ": " << (this->_sketches[i].empty() ? std::string("no jets") : quantileText(this->_sketches[i], percentiles)) << std::endl;
+        }
+    }
+
+    //For the checkpoints
+    std::vector<QuantileSketch*> sketches(){
+        std::vector<QuantileSketch*> sketches;
+        for(QuantileSketch &sketch: this->_sketches){
+            sketches.push_back(&sketch);
+        }
+        return sketches;
+    }
+
+private:
+    std::vector<QuantileSketch> _sketches;    //The dark jets, then the other jets, in the order of observableNames
+};
\ No newline at end of file
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <sys/resource.h>
+#include <unistd.h>
+#include <chrono>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include "GetEnvVars.hpp"
+#include "Timing.hpp"
+
+//Periodic progress reports for long runs: events/s, the rates of named counters and, when compiled with DARKJET_TIMING, of the phases of Timing.hpp, resident memory and the estimated time left. They are off unless TELEMETRY_INTERVAL is set.
+//Each report is printed to stderr and replaces the stats file, so a batch job that stopped updating its stats file is stalled.
+//Not thread-safe, all calls should come from the thread that sees the events (the analysis itself, or the merging thread of a multithreaded program).
+class Telemetry{
+public:
+    //totalEvents is used for the estimated time left if TOTAL_EVENTS isn't set, negative if unknown
+    explicit Telemetry(const std::string &analysis, long totalEvents = -1):
+        _analysis(analysis),
+        _interval(getDoubleFromEnvVar("TELEMETRY_INTERVAL", 0.0)),
+        _path(getStringFromEnvVar("TELEMETRY_FILE", "../Outputs/" + analysis + "Telemetry.json")),
+        _totalEvents(totalEvents),
+        _events(0),
+        _eventsAtLastReport(0),
+        _start(std::chrono::steady_clock::now()),
+        _lastReport(_start)
+    {
+        if(std::getenv("TOTAL_EVENTS") != nullptr){
+            this->_totalEvents = getIntFromEnvVar("TOTAL_EVENTS", totalEvents);
+        }
+    }
+
+    //Counts events, and reports if it has been at least TELEMETRY_INTERVAL seconds since the last report
+    void event(long events = 1){
+        this->_events += events;
+        if(this->_interval > 0){
+            const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            if(now - this->_lastReport >= std::chrono::duration<double>(this->_interval)){
+                this->report(now, false);
+            }
+        }
+    }
+
+    //Adds amount to the counter name, whose rate is reported together with the event rate. The counters are found by name, so there should only be a few of them.
+    void count(const std::string &name, long amount = 1){
+        for(Counter &counter: this->_counters){
+            if(counter.name == name){
+                counter.value += amount;
+                return;
+            }
+        }
+        this->_counters.push_back(Counter{name, amount, 0});
+    }
+
+    //Final report, to call at the end of finalize
+    void finish(){
+        if(this->_interval > 0){
+            this->report(std::chrono::steady_clock::now(), true);
+        }
+    }
+
+    long events() const{
+        return this->_events;
+    }
+
+private:
+    struct Counter{
+        std::string name;
+        long value;
+        long valueAtLastReport;
+    };
+
+    void report(std::chrono::steady_clock::time_point now, bool final){
+        const double elapsed = std::chrono::duration<double>(now - this->_start).count();
+        const double sinceLastReport = std::chrono::duration<double>(now - this->_lastReport).count();
+        const double rate = elapsed > 0 ? this->_events / elapsed : 0.0;
+        const double recentRate = sinceLastReport > 0 ? (this->_events - this->_eventsAtLastReport) / sinceLastReport : 0.0;
+        const double eta = (this->_totalEvents >= 0 && rate > 0) ? std::max(this->_totalEvents - this->_events, 0L) / rate : -1.0;
+        const std::pair<double, double> memory = residentMemory();
+
+        std::ostringstream line;
+        line << std::setprecision(3);
+        line << this->_analysis << (final ? " finished: " : ": ") << this->_events << " events";
+        if(this->_totalEvents >= 0){
+            line << " of " << this->_totalEvents;
+        }
+        line << " in " << formatDuration(elapsed) << ", " << rate << " events/s";
+        if(!final){
+            line << " (" << recentRate << " events/s in the last " << formatDuration(sinceLastReport) << ")";
+        }
+        for(const Counter &counter: this->_counters){
+            line << ", " << counter.name << ": " << counter.value << " (" << (elapsed > 0 ? counter.value / elapsed : 0.0) << "/s)";
+        }
+        line << ", memory: " << memory.first << " MB (peak " << memory.second << " MB)";
+        if(eta >= 0 && !final){
+            line << ", time left: " << formatDuration(eta);
+        }
+        std::cerr << line.str() << std::endl;
+
+        //The calls per second of each phase, and its seconds per second, which is the average number of threads in it
+        std::vector<std::pair<std::string, PhaseTiming>> phases;
+#ifdef DARKJET_TIMING
+        phases = TimingRegistry::instance().phaseTotals();
+#endif
+        if(!phases.empty()){
+            std::ostringstream phaseLine;
+            phaseLine << std::setprecision(3) << "    Phases:";
+            for(std::size_t i = 0; i < phases.size(); i++){
+                phaseLine << (i == 0 ? " " : ", ") << phases[i].first << ": " << (elapsed > 0 ? phases[i].second.calls / elapsed : 0.0) << " calls/s (" << (elapsed > 0 ? phases[i].second.nanoseconds * 1e-9 / elapsed : 0.0) << " s/s)";
+            }
+            std::cerr << phaseLine.str() << std::endl;
+        }
+
+        //Write to a temporary file and rename it, so that the stats file is never read half-written
+        const std::string temporaryPath = this->_path + ".tmp";
+        std::ofstream file(temporaryPath);
+        file << "{" << std::endl
+            << "    \"analysis\": \"" << this->_analysis << "\"," << std::endl
+            << "    \"finished\": " << (final ? "true" : "false") << "," << std::endl
+            << "    \"updated\": " << std::time(nullptr) << "," << std::endl
+            << "    \"elapsedSeconds\": " << elapsed << "," << std::endl
+            << "    \"events\": " << this->_events << "," << std::endl
+            << "    \"totalEvents\": " << this->_totalEvents << "," << std::endl
+            << "    \"eventsPerSecond\": " << rate << "," << std::endl
+            << "    \"recentEventsPerSecond\": " << recentRate << "," << std::endl
+            << "    \"secondsLeft\": " << eta << "," << std::endl
+            << "    \"residentMemoryMB\": " << memory.first << "," << std::endl
+            << "    \"peakResidentMemoryMB\": " << memory.second << "," << std::endl
+            << "    \"counters\": {";
+        for(std::size_t i = 0; i < this->_counters.size(); i++){
+            const Counter &counter = this->_counters[i];
+            file << (i == 0 ? "" : ",") << std::endl << "        \"" << counter.name << "\": {\"value\": " << counter.value << ", \"perSecond\": " << (elapsed > 0 ? counter.value / elapsed : 0.0)
+                << ", \"recentPerSecond\": " << (sinceLastReport > 0 ? (counter.value - counter.valueAtLastReport) / sinceLastReport : 0.0) << "}";
+        }
+        file << std::endl << "    }," << std::endl << "    \"phases\": {";
+        for(std::size_t i = 0; i < phases.size(); i++){
+            const PhaseTiming &phase = phases[i].second;
+            const PhaseTiming previous = i < this->_phasesAtLastReport.size() ? this->_phasesAtLastReport[i] : PhaseTiming();
+            file << (i == 0 ? "" : ",") << std::endl << "        \"" << phases[i].first << "\": {\"calls\": " << phase.calls << ", \"seconds\": " << phase.nanoseconds * 1e-9
+                << ", \"callsPerSecond\": " << (elapsed > 0 ? phase.calls / elapsed : 0.0) << ", \"recentCallsPerSecond\": " << (sinceLastReport > 0 ? (phase.calls - previous.calls) / sinceLastReport : 0.0)
+                << ", \"secondsPerSecond\": " << (elapsed > 0 ? phase.nanoseconds * 1e-9 / elapsed : 0.0) << "}";
+        }
+        file << std::endl << "    }" << std::endl << "}" << std::endl;
+        file.close();
+        if(!file || std::rename(temporaryPath.c_str(), this->_path.c_str()) != 0){
+            std::cerr << "Could not write the telemetry to " << this->_path << "." << std::endl;
+        }
+
+        this->_lastReport = now;
+        this->_eventsAtLastReport = this->_events;
+        for(Counter &counter: this->_counters){
+            counter.valueAtLastReport = counter.value;
+        }
+        this->_phasesAtLastReport.clear();
+        for(const std::pair<std::string, PhaseTiming> &phase: phases){
+            this->_phasesAtLastReport.push_back(phase.second);
+        }
+    }
+
+    //Current and peak resident memory in MB, -1 if not available
+    static std::pair<double, double> residentMemory(){
+        double current = -1.0, peak = -1.0;
+        std::ifstream statm("/proc/self/statm");
+        long size, resident;
+        if(statm >> size >> resident){
+            current = resident * (sysconf(_SC_PAGESIZE) / 1048576.0);
+        }
+        struct rusage usage;
+        if(getrusage(RUSAGE_SELF, &usage) == 0){
+            peak = usage.ru_maxrss / 1024.0;    //In kB on Linux
+        }
+        return {current, peak};
+    }
+
+    static std::string formatDuration(double seconds){
+        const long s = seconds + 0.5;
+        std::ostringstream result;
+        if(s >= 3600){
+            result << s / 3600 << " h " << s % 3600 / 60 << " min";
+        }
+        else if(s >= 60){
+            result << s / 60 << " min " << s % 60 << " s";
+        }
+        else{
+            result << seconds << " s";
+        }
+        return result.str();
+    }
+
+    const std::string _analysis;
+    const double _interval;
+    const std::string _path;
+    long _totalEvents;
+    long _events, _eventsAtLastReport;
+    std::vector<Counter> _counters;
+    std::vector<PhaseTiming> _phasesAtLastReport;    //In the order of TimingRegistry::phaseTotals, which only appends new phases
+    const std::chrono::steady_clock::time_point _start;
+    std::chrono::steady_clock::time_point _lastReport;
+};
\ No newline at end of file
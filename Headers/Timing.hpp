@@ -0,0 +1,262 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <fstream>
+#include <iostream>
+#include <cstdint>
+#include <utility>
+#include "GetEnvVars.hpp"
+
+//Instrumentation of where the time goes in an analysis. Use it through the macros at the bottom of this file, which expand to nothing unless DARKJET_TIMING is defined (TIMING=1 ./CompileAndRun.sh ...), so normal runs don't pay anything for it.
+//Each thread records into its own TimingRecord. Its lock is only contended when another thread reads the records, which happens for the telemetry reports and the summary, so recording costs little more than reading the clock.
+
+enum class TimingKind{
+    PHASE = 0,           //Time spent in a scope, including the time in phases nested inside it
+    COUNTER = 1,         //Sum of integers, for example the number of events
+    DISTRIBUTION = 2     //How many times each small non-negative integer was recorded, for example genealogy walk depths
+};
+
+struct PhaseTiming{
+    std::uint64_t calls = 0;
+    std::uint64_t nanoseconds = 0;
+};
+
+//Everything recorded by one thread, indexed by the ids from TimingRegistry::id. The methods lock the record, and other threads must lock mutex to read it.
+struct TimingRecord{
+    std::vector<PhaseTiming> phases;
+    std::vector<std::uint64_t> counters;
+    std::vector<std::vector<std::uint64_t>> distributions;
+    std::mutex mutex;
+
+    void addPhase(std::size_t id, std::uint64_t calls, std::uint64_t nanoseconds){
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if(id >= this->phases.size()){
+            this->phases.resize(id + 1);
+        }
+        this->phases[id].calls += calls;
+        this->phases[id].nanoseconds += nanoseconds;
+    }
+
+    void count(std::size_t id, std::uint64_t amount){
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if(id >= this->counters.size()){
+            this->counters.resize(id + 1, 0);
+        }
+        this->counters[id] += amount;
+    }
+
+    void record(std::size_t id, std::size_t value, std::uint64_t times = 1){
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if(id >= this->distributions.size()){
+            this->distributions.resize(id + 1);
+        }
+        std::vector<std::uint64_t> &distribution = this->distributions[id];
+        if(value >= distribution.size()){
+            distribution.resize(value + 1, 0);
+        }
+        distribution[value] += times;
+    }
+
+    void merge(TimingRecord &other){
+        std::lock_guard<std::mutex> lock(other.mutex);
+        for(std::size_t id = 0; id < other.phases.size(); id++){
+            this->addPhase(id, other.phases[id].calls, other.phases[id].nanoseconds);
+        }
+        for(std::size_t id = 0; id < other.counters.size(); id++){
+            this->count(id, other.counters[id]);
+        }
+        for(std::size_t id = 0; id < other.distributions.size(); id++){
+            for(std::size_t value = 0; value < other.distributions[id].size(); value++){
+                this->record(id, value, other.distributions[id][value]);
+            }
+        }
+    }
+};
+
+//The names of the phases, counters and distributions, and the records of all threads
+class TimingRegistry{
+public:
+    static TimingRegistry& instance(){
+        static TimingRegistry registry;
+        return registry;
+    }
+
+    //Id of the entry with the given name and kind, registering it the first time. The macros only call this once per call site.
+    std::size_t id(const std::string &name, TimingKind kind){
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        std::vector<std::string> &names = this->_names[static_cast<int>(kind)];
+        for(std::size_t i = 0; i < names.size(); i++){
+            if(names[i] == name){
+                return i;
+            }
+        }
+        names.push_back(name);
+        return names.size() - 1;
+    }
+
+    //The record of the calling thread
+    TimingRecord& threadRecord(){
+        thread_local TimingRecord *record = nullptr;
+        if(record == nullptr){
+            std::lock_guard<std::mutex> lock(this->_mutex);
+            this->_records.emplace_back(new TimingRecord());
+            record = this->_records.back().get();
+        }
+        return *record;
+    }
+
+    //The names of the phases and their calls and time, summed over all threads so far. The other threads can keep recording.
+    std::vector<std::pair<std::string, PhaseTiming>> phaseTotals(){
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        TimingRecord total;
+        for(const std::unique_ptr<TimingRecord> &record: this->_records){
+            total.merge(*record);
+        }
+        const std::vector<std::string> &phaseNames = this->_names[static_cast<int>(TimingKind::PHASE)];
+        std::vector<std::pair<std::string, PhaseTiming>> phases;
+        for(std::size_t id = 0; id < phaseNames.size(); id++){
+            phases.emplace_back(phaseNames[id], id < total.phases.size() ? total.phases[id] : PhaseTiming());
+        }
+        return phases;
+    }
+
+    //Writes the records of all threads, merged, together with the time per thread of each phase
+    bool writeSummary(const std::string &path, const std::string &analysis){
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        std::ofstream file(path);
+        if(!file){
+            std::cerr << "Could not write the timing summary to " << path << "." << std::endl;
+            return false;
+        }
+        TimingRecord total;
+        for(const std::unique_ptr<TimingRecord> &record: this->_records){
+            total.merge(*record);
+        }
+        const std::vector<std::string> &phaseNames = this->_names[static_cast<int>(TimingKind::PHASE)];
+        const std::vector<std::string> &counterNames = this->_names[static_cast<int>(TimingKind::COUNTER)];
+        const std::vector<std::string> &distributionNames = this->_names[static_cast<int>(TimingKind::DISTRIBUTION)];
+
+        file << "{" << std::endl << "    \"analysis\": " << jsonString(analysis) << "," << std::endl << "    \"threads\": " << this->_records.size() << "," << std::endl;
+        file << "    \"phases\": {";
+        for(std::size_t id = 0; id < phaseNames.size(); id++){
+            const PhaseTiming phase = id < total.phases.size() ? total.phases[id] : PhaseTiming();
+            file << (id == 0 ? "" : ",") << std::endl << "        " << jsonString(phaseNames[id]) << ": {\"calls\": " << phase.calls << ", \"seconds\": " << phase.nanoseconds * 1e-9
+                << ", \"microsecondsPerCall\": " << (phase.calls > 0 ? phase.nanoseconds * 1e-3 / phase.calls : 0.0) << ", \"secondsPerThread\": [";
+            for(std::size_t thread = 0; thread < this->_records.size(); thread++){
+                std::lock_guard<std::mutex> recordLock(this->_records[thread]->mutex);
+                const std::vector<PhaseTiming> &phases = this->_records[thread]->phases;
+                file << (thread == 0 ? "" : ", ") << (id < phases.size() ? phases[id].nanoseconds * 1e-9 : 0.0);
+            }
+            file << "]}";
+        }
+        file << std::endl << "    }," << std::endl << "    \"counters\": {";
+        for(std::size_t id = 0; id < counterNames.size(); id++){
+            file << (id == 0 ? "" : ",") << std::endl << "        " << jsonString(counterNames[id]) << ": " << (id < total.counters.size() ? total.counters[id] : 0);
+        }
+        file << std::endl << "    }," << std::endl << "    \"distributions\": {";
+        for(std::size_t id = 0; id < distributionNames.size(); id++){
+            const std::vector<std::uint64_t> counts = id < total.distributions.size() ? total.distributions[id] : std::vector<std::uint64_t>();
+            std::uint64_t entries = 0;
+            double sum = 0.0;
+            for(std::size_t value = 0; value < counts.size(); value++){
+                entries += counts[value];
+                sum += static_cast<double>(value) * counts[value];
+            }
+            file << (id == 0 ? "" : ",") << std::endl << "        " << jsonString(distributionNames[id]) << ": {\"entries\": " << entries << ", \"mean\": " << (entries > 0 ? sum / entries : 0.0)
+                << ", \"max\": " << (counts.empty() ? 0 : counts.size() - 1) << ", \"counts\": [";
+            for(std::size_t value = 0; value < counts.size(); value++){
+                file << (value == 0 ? "" : ", ") << counts[value];
+            }
+            file << "]}";
+        }
+        file << std::endl << "    }" << std::endl << "}" << std::endl;
+        std::cout << "Timing summary written to " << path << std::endl;
+        return true;
+    }
+
+private:
+    TimingRegistry(){}
+
+    static std::string jsonString(const std::string &str){
+        std::string result = "\"";
+        for(const char c: str){
+            if(c == '"' || c == '\\'){
+                result += '\\';
+            }
+            result += c;
+        }
+        return result + "\"";
+    }
+
+    std::mutex _mutex;
+    std::vector<std::string> _names[3];
+    std::vector<std::unique_ptr<TimingRecord>> _records;
+};
+
+//Adds the time from construction to destruction to a phase of the calling thread, and if distributionId is given, also records it in that distribution as the number of binary digits of the microseconds: k for 2^(k - 1) to 2^k - 1 microseconds, and 0 below 1 microsecond. The steps of a factor of 2 show the spread of the times from microseconds to seconds in a few dozen values.
+class ScopedTimer{
+public:
+    explicit ScopedTimer(std::size_t id, std::size_t distributionId = noDistribution): _id(id), _distributionId(distributionId), _start(std::chrono::steady_clock::now()){}
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+    ~ScopedTimer(){
+        TimingRecord &record = TimingRegistry::instance().threadRecord();
+        const std::uint64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->_start).count();
+        record.addPhase(this->_id, 1, nanoseconds);
+        if(this->_distributionId != noDistribution){
+            std::size_t digits = 0;
+            for(std::uint64_t microseconds = nanoseconds / 1000; microseconds > 0; microseconds >>= 1){
+                digits++;
+            }
+            record.record(this->_distributionId, digits);
+        }
+    }
+
+    static constexpr std::size_t noDistribution = static_cast<std::size_t>(-1);
+
+private:
+    const std::size_t _id, _distributionId;
+    const std::chrono::steady_clock::time_point _start;
+};
+
+//The file the summary of an analysis is written to, set by the environment variable TIMING_JSON
+inline std::string timingSummaryPath(const std::string &analysis){
+    return getStringFromEnvVar("TIMING_JSON", "../Outputs/" + analysis + "Timing.json");
+}
+
+#define DARKJET_TIMING_CONCATENATE_(a, b) a##b
+#define DARKJET_TIMING_CONCATENATE(a, b) DARKJET_TIMING_CONCATENATE_(a, b)
+
+#ifdef DARKJET_TIMING
+//Times the rest of the enclosing scope as the phase name
+#define TIME_SCOPE(name) \
+    static const std::size_t DARKJET_TIMING_CONCATENATE(timingId, __LINE__) = TimingRegistry::instance().id(name, TimingKind::PHASE); \
+    const ScopedTimer DARKJET_TIMING_CONCATENATE(scopedTimer, __LINE__)(DARKJET_TIMING_CONCATENATE(timingId, __LINE__))
+//Same as TIME_SCOPE, and also records the time of each call in the distribution "<name> log2 microseconds" like ScopedTimer, for phases where the spread between events matters and not only the total, like the clustering
+#define TIME_SCOPE_PER_CALL(name) \
+    static const std::size_t DARKJET_TIMING_CONCATENATE(timingId, __LINE__) = TimingRegistry::instance().id(name, TimingKind::PHASE); \
+    static const std::size_t DARKJET_TIMING_CONCATENATE(timingDistributionId, __LINE__) = TimingRegistry::instance().id(std::string(name) + " log2 microseconds", TimingKind::DISTRIBUTION); \
+    const ScopedTimer DARKJET_TIMING_CONCATENATE(scopedTimer, __LINE__)(DARKJET_TIMING_CONCATENATE(timingId, __LINE__), DARKJET_TIMING_CONCATENATE(timingDistributionId, __LINE__))
+//Adds amount to the counter name
+#define TIMING_COUNT(name, amount) do{ \
+    static const std::size_t timingId = TimingRegistry::instance().id(name, TimingKind::COUNTER); \
+    TimingRegistry::instance().threadRecord().count(timingId, amount); \
+}while(false)
+//Records value in the distribution name
+#define TIMING_RECORD(name, value) do{ \
+    static const std::size_t timingId = TimingRegistry::instance().id(name, TimingKind::DISTRIBUTION); \
+    TimingRegistry::instance().threadRecord().record(timingId, value); \
+}while(false)
+//Writes the JSON summary for the analysis, to call at the end of finalize
+#define TIMING_WRITE_SUMMARY(analysis) TimingRegistry::instance().writeSummary(timingSummaryPath(analysis), analysis)
+#else
+#define TIME_SCOPE(name)
+#define TIME_SCOPE_PER_CALL(name)
+#define TIMING_COUNT(name, amount) ((void)0)    //amount and value aren't evaluated, so variables that are only computed for them should be under #ifdef DARKJET_TIMING too
+#define TIMING_RECORD(name, value) ((void)0)
+#define TIMING_WRITE_SUMMARY(analysis) do{}while(false)
+#endif
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <future>
+#include <functional>
+#include <memory>
+#include <deque>
+#include <vector>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
+
+//Thread pool where each worker has its own queue of tasks. New tasks are spread over the queues in turn. A worker takes the oldest task of its own queue, and when that is empty it steals the oldest task of another queue, so that a few slow tasks don't leave the other workers idle and the tasks finish roughly in the order they were submitted.
+class WorkStealingPool{
+public:
+    explicit WorkStealingPool(int threads): _nextQueue(0), _queuedTasks(0), _stopping(false){
+        for(int i = 0; i < std::max(threads, 1); i++){
+            this->_queues.emplace_back(new Queue());
+        }
+        for(std::size_t i = 0; i < this->_queues.size(); i++){
+            this->_threads.emplace_back(&WorkStealingPool::work, this, i);
+        }
+    }
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    //Runs the tasks that are still queued, then stops the threads
+    ~WorkStealingPool(){
+        {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+            this->_stopping = true;
+        }
+        this->_wake.notify_all();
+        for(std::thread &thread: this->_threads){
+            thread.join();
+        }
+    }
+
+    //Queues task(), and returns a future that gets its result (or the exception it throws)
+    template<typename Function> std::future<typename std::invoke_result<Function>::type> submit(Function task){
+        typedef typename std::invoke_result<Function>::type Result;
+        const std::shared_ptr<std::packaged_task<Result()>> packagedTask = std::make_shared<std::packaged_task<Result()>>(std::move(task));
+        std::future<Result> result = packagedTask->get_future();
+        Queue &queue = *this->_queues[this->_nextQueue++ % this->_queues.size()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back([packagedTask]{
+                (*packagedTask)();
+            });
+        }
+        {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+            this->_queuedTasks++;
+        }
+        this->_wake.notify_one();
+        return result;
+    }
+
+    int threads() const{
+        return this->_threads.size();
+    }
+
+private:
+    struct Queue{
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    //Takes the oldest task of queue number index, or else of the next queue that has one
+    bool takeTask(std::size_t index, std::function<void()> &task){
+        for(std::size_t i = 0; i < this->_queues.size(); i++){
+            Queue &queue = *this->_queues[(index + i) % this->_queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if(!queue.tasks.empty()){
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                this->_queuedTasks--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void work(std::size_t index){
+        std::function<void()> task;
+        while(true){
+            if(this->takeTask(index, task)){
+                task();
+                task = nullptr;
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(this->_mutex);
+            this->_wake.wait(lock, [this]{
+                return this->_queuedTasks > 0 || this->_stopping;
+            });
+            if(this->_stopping && this->_queuedTasks == 0){
+                return;
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> _queues;
+    std::vector<std::thread> _threads;
+    std::atomic<std::size_t> _nextQueue;
+    std::atomic<long> _queuedTasks;    //Increased under _mutex, so that a worker can't miss a new task between checking and waiting
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    bool _stopping;
+};
\ No newline at end of file
@@ -1,12 +1,21 @@
 args=("$@")
 
 build(){
-    rivet-build -r ${args[0]}.cpp -std=c++17 -Wno-switch -Wno-unused-function -Wno-deprecated-declarations    #-Wno-switch because that warning is just stupid, -Wno-unused-function to be able to reuse headers in different analyses, and -Wno-deprecated-declarations to avoid warnings from Root/Rivet internal files
+    if [[ "$TIMING" == 1 ]]
+    then
+        timingFlags=-DDARKJET_TIMING    #Compiles in the timers of Headers/Timing.hpp
+    fi
+    rivet-build -r ${args[0]}.cpp -std=c++17 -Wno-switch -Wno-unused-function -Wno-deprecated-declarations $timingFlags && echo -n "$TIMING" > .timing    #-Wno-switch because that warning is just stupid, -Wno-unused-function to be able to reuse headers in different analyses, and -Wno-deprecated-declarations to avoid warnings from Root/Rivet internal files
 }
 
 run(){
     if [[ $(file "${args[1]}") == *ROOT\ file* && ("${args[1]}" == */EVNT.* || "${args[1]}" == EVNT.*) ]]
     then
+        skipWeights=True
+        if [[ "$WEIGHT_VARIATIONS" == 1 ]]
+        then
+            skipWeights=False    #Rivet_i only passes the weight variations on to the analysis without SkipWeights
+        fi
         echo "theApp.EvtMax = 1830
 
 import AthenaPoolCnvSvc.ReadAthenaPool
@@ -30,7 +39,7 @@ rivet.RunName = ''
 rivet.HistoFile = '/dev/null'
 rivet.CrossSection = 1.0
 rivet.OutputLevel = 0
-rivet.SkipWeights=True
+rivet.SkipWeights=$skipWeights
 job += rivet" > .rivet_JO.py
         athena .rivet_JO.py
         rm .rivet_JO.py
@@ -40,7 +49,7 @@ job += rivet" > .rivet_JO.py
     rm -f neg_weights.dat pos_weights.dat Rivet.yoda weights.dat eventLoopHeartBeat.txt PoolFileCatalog.xml PoolFileCatalog.xml.BAK
 }
 
-if [[ "$1.cpp" -nt "RivetAnalysis.so" || $(rivet --list --pwd) != *${args[0]}* ]]
+if [[ "$1.cpp" -nt "RivetAnalysis.so" || $(rivet --list --pwd) != *${args[0]}* || "$TIMING" != "$(cat .timing 2>/dev/null)" ]]    #Also rebuild when TIMING changes
 then
     build && run
 else
@@ -1,122 +1,193 @@
-#include <Rivet/Analysis.hh>
-#include <Rivet/Projections/FinalState.hh>
-#include <Rivet/Projections/ChargedFinalState.hh>
-#include <Rivet/Projections/FastJets.hh>
-#include <Rivet/Math/Vector4.hh>
-#include <iostream>
-#include <vector>
-#include <map>
-#include "../Headers/Darkness.hpp"
-#include "../Headers/Decay.hpp"
-#include "../Headers/ParticleName.hpp"
-#include "../Headers/ParticleSort.hpp"
-
-namespace Rivet{
-    class JetContents: public Analysis{
-    public:
-        JetContents(): Analysis("JetContents"), _darkParticles(0), _darkPT(0.0), _totalNumberOfParticles(0), _totalPT(0.0), _firstEvent(true){}
-
-        virtual void init() override{
-            const FinalState cnfs;
-            const ChargedFinalState cfs(cnfs);
-            this->declare(cnfs, "FS");
-            this->declare(cfs, "CFS");
-            this->declare(FastJets(cnfs, FastJets::ANTIKT, 1.0, JetAlg::Muons::ALL, JetAlg::Invisibles::ALL), "Jets");
-        }
-
-        virtual void analyze(const Event& event) override{
-            const FinalState &cnfs = apply<FinalState>(event, "FS");
-            const Particles &cparticles = apply<FinalState>(event, "CFS").particles();
-            const Jets &jets = apply<FastJets>(event, "Jets").jetsByPt();
-
-            //Calculate the particle contents of the jet
-            for(const Jet &jet: jets){
-                for(const Particle &particle: jet.particles()){
-                    const PdgId pdgid = particle.pid();
-                    this->_jetContents[pdgid]++;
-                    this->_totalNumberOfParticles++;
-                    this->_jetContentsByPT[pdgid] += particle.pT();
-                    this->_totalPT += particle.pT();
-
-                    if(hasDarkAncestor(particle)){
-                        this->_darkParticles++;
-                        this->_darkPT += particle.pT();
-                    }
-
-                    this->_decays[pdgid][Decay::fromChild(particle)]++;
-                }
-            }
-
-            //Calculate the total energy and 3-momentum (only do this for the first event, otherwise there will be so much output that it will be unreadable)
-            if(this->_firstEvent){
-                double totalEnergy = 0, totalChargedEnergy = 0;
-                Vector3 totalMomentum(0, 0, 0), totalChargedMomentum(0, 0, 0);
-
-                for(const Particle &particle: cnfs.particles()){
-                    totalEnergy += particle.momentum().t();
-                    totalMomentum += particle.momentum().vector3();
-                }
-
-                for(const Particle &chargedParticle: cparticles){
-                    totalChargedEnergy += chargedParticle.momentum().t();
-                    totalChargedMomentum += chargedParticle.momentum().vector3();
-                }
-
-                std::cout << "Total energy: " << totalEnergy << " GeV" << std::endl;
-                std::cout << "Total 3-momentum: " << totalMomentum.mod() << " GeV" << std::endl;
-                std::cout << "Total energy of charged particles: " << totalChargedEnergy << " GeV" << std::endl;
-                std::cout << "Total 3-momentum of charged particles: " << totalChargedMomentum.mod() << " GeV" << std::endl;
-                this->_firstEvent = false;
-            }
-        }
-
-        virtual void finalize() override{
-            //Sort the particles by frequency
-            const auto sortedJetContents = sortMap(this->_jetContents);
-            const auto sortedJetContentsByPT = sortMap(this->_jetContentsByPT);
-
-            //Print and plot the jet contents
-            std::cout << std::endl << "Average multiplicity fraction of all jets in all events:" << std::endl << "----" << std::endl;
-            for(const std::pair<int, int> &particleCount: sortedJetContents){
-                const double fraction = 100.0 * particleCount.second / this->_totalNumberOfParticles;
-                std::cout << particleName(particleCount.first) << ": " << fraction << "%" << std::endl;
-            }
-
-            //Print the jet contents by pT
-            std::cout << std::endl << "Average pT-fraction of all jets in all events:" << std::endl << "----" << std::endl;
-            for(const std::pair<int, double> &particlePt: sortedJetContentsByPT){
-                std::cout << particleName(particlePt.first) << ": " << (100.0 * particlePt.second / this->_totalPT) << "%" << std::endl;
-            }
-
-            //Print the parents of photons and leptons
-            for(PdgId child: {PID::PHOTON, PID::ELECTRON, PID::MUON}){
-                const auto sortedParents = sortMap(this->_decays[child]);
-                std::cout << std::endl << "Parent particles of " << particleName(child) << ":" << std::endl << "----" << std::endl;
-                for(const std::pair<Decay, int> &parentCount: sortedParents){
-                    const double fraction = 100.0 * parentCount.second / this->_jetContents[child];
-                    if(fraction < (child == PID::PHOTON ? 0.1 : 1)){
-                        break;
-                    }
-                    std::cout << parentCount.first << ": " << fraction << "%" << std::endl;
-                }
-            }
-
-            //Print the darkness
-            std::cout << std::endl;
-            std::cout << "Multiplicity fraction of particles with dark ancestors: " << (100.0 * this->_darkParticles / this->_totalNumberOfParticles) << "%" << std::endl;
-            std::cout << "pT-fraction of particles with dark ancestors: " << (100.0 * this->_darkPT / this->_totalPT) << "%" << std::endl;
-        }
-
-    private:
-        std::map<PdgId, int> _jetContents;
-        std::map<PdgId, double> _jetContentsByPT;
-        int _darkParticles;
-        double _darkPT;
-        std::map<PdgId, std::map<Decay, int>> _decays;
-        int _totalNumberOfParticles;
-        double _totalPT;
-        bool _firstEvent;
-    };
-
-    DECLARE_RIVET_PLUGIN(JetContents);
+#include <Rivet/Analysis.hh>
+#include <Rivet/Projections/FinalState.hh>
+#include <Rivet/Projections/ChargedFinalState.hh>
+#include <Rivet/Projections/FastJets.hh>
+#include <Rivet/Math/Vector4.hh>
+#include <iostream>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include "../Headers/DarknessRivet.hpp"
+#include "../Headers/Decay.hpp"
+#include "../Headers/ParticleName.hpp"
+#include "../Headers/ParticleSortRivet.hpp"
+#include "../Headers/PdgIdRegistry.hpp"
+#include "../Headers/GetEnvVars.hpp"
+#include "../Headers/Timing.hpp"
+#include "../Headers/Telemetry.hpp"
+#include "../Headers/JetCompositionRivet.hpp"
+#include "../Headers/JetClusteringRivet.hpp"
+#include "../Headers/Substructure.hpp"
+
+namespace Rivet{
+    class JetContents: public Analysis{
+    public:
+        JetContents():
+            Analysis("JetContents"),
+            _darkParticles(0),
+            _darkPT(0.0),
+            _decayPdgIds(getIntVectorFromEnvVar("DECAY_PDGIDS", std::vector<int>{PID::PHOTON, PID::ELECTRON, PID::MUON})),
+            _decaySampling(std::max(1, getIntFromEnvVar("DECAY_SAMPLING", 1))),
+            _decaySamplingCounter(0),
+            _totalNumberOfParticles(0),
+            _totalPT(0.0),
+            _firstEvent(true),
+            _darknessRecombiner(clusterParticlesFirstIndex),
+            _substructure(getIntFromEnvVar("SUBSTRUCTURE", 0)),
+            _substructureCalculator(this->_jetRadius),
+            _telemetry("JetContents")
+        {}
+
+        virtual void init() override{
+            const FinalState cnfs;
+            const ChargedFinalState cfs(cnfs);
+            this->declare(cnfs, "FS");
+            this->declare(cfs, "CFS");
+            const FinalState clusteredParticles(particleCut(this->_clustering));    //The whole final state unless MAX_PARTICLE_ETA is set
+            this->declare(clusteredParticles, "ClusteredFS");    //Clustered with the DarknessRecombiner of this analysis, invisibles included
+        }
+
+        virtual void analyze(const Event& event) override{
+            TIME_SCOPE("analyze");
+            TIMING_COUNT("events", 1);
+            this->_telemetry.event();
+            const FinalState &cnfs = apply<FinalState>(event, "FS");
+            const Particles &cparticles = apply<FinalState>(event, "CFS").particles();
+            Jets jets;
+            {
+                TIME_SCOPE_PER_CALL("clustering");
+                const Particles &clusteredParticles = apply<FinalState>(event, "ClusteredFS").particles();
+                TIMING_COUNT("clustered particles", clusteredParticles.size());
+                setJetCompositionInputs(this->_darknessRecombiner, clusteredParticles);
+                jets = clusterParticles(clusteredParticles, this->_darknessRecombiner.jetDefinition(fastjet::antikt_algorithm, this->_jetRadius, this->_clustering.strategy), jetCut(this->_clustering));
+                keepLeadingJets(jets, this->_clustering);
+            }
+
+            //Calculate the particle contents of the jet
+            TIME_SCOPE("jet contents");
+            for(const Jet &jet: jets){
+                TIMING_RECORD("jet constituents", jet.particles().size());
+                const JetComposition &composition = jetComposition(jet, this->_darknessRecombiner);
+                this->_darkParticles += composition.dark.multiplicity;
+                this->_darkPT += composition.dark.scalarPT;
+                if(this->_substructure){
+                    this->_substructureSummary.fill(this->_substructureCalculator.compute(jet.pseudojet(), composition));
+                }
+                for(const Particle &particle: jet.particles()){
+                    const PdgId pdgid = particle.pid();
+                    const std::size_t slot = this->_pdgIds.slot(pdgid);
+                    if(slot == this->_jetContents.size()){
+                        this->_jetContents.push_back(0);
+                        this->_jetContentsByPT.push_back(0.0);
+                        this->_trackDecays.push_back(std::find(this->_decayPdgIds.begin(), this->_decayPdgIds.end(), pdgid) != this->_decayPdgIds.end());
+                    }
+                    this->_jetContents[slot]++;
+                    this->_totalNumberOfParticles++;
+                    this->_jetContentsByPT[slot] += particle.pT();
+                    this->_totalPT += particle.pT();
+
+                    //Only find the decay that produced the particle for the particle types that are printed in finalize, and optionally only for every Nth such particle
+                    if(this->_trackDecays[slot] && this->_decaySamplingCounter++ % this->_decaySampling == 0){
+                        TIME_SCOPE("decay bookkeeping");
+                        this->_telemetry.count("decays found");
+                        this->_decays[pdgid][Decay::fromChild(particle)]++;
+                        this->_numberOfSampledDecays[pdgid]++;
+                    }
+                }
+            }
+
+            //Calculate the total energy and 3-momentum (only do this for the first event, otherwise there will be so much output that it will be unreadable)
+            if(this->_firstEvent){
+                double totalEnergy = 0, totalChargedEnergy = 0;
+                Vector3 totalMomentum(0, 0, 0), totalChargedMomentum(0, 0, 0);
+
+                for(const Particle &particle: cnfs.particles()){
+                    totalEnergy += particle.momentum().t();
+                    totalMomentum += particle.momentum().vector3();
+                }
+
+                for(const Particle &chargedParticle: cparticles){
+                    totalChargedEnergy += chargedParticle.momentum().t();
+                    totalChargedMomentum += chargedParticle.momentum().vector3();
+                }
+
+                std::cout << "Total energy: " << totalEnergy << " GeV" << std::endl;
+                std::cout << "Total 3-momentum: " << totalMomentum.mod() << " GeV" << std::endl;
+                std::cout << "Total energy of charged particles: " << totalChargedEnergy << " GeV" << std::endl;
+                std::cout << "Total 3-momentum of charged particles: " << totalChargedMomentum.mod() << " GeV" << std::endl;
+                this->_firstEvent = false;
+            }
+        }
+
+        virtual void finalize() override{
+            //Sort the particles by frequency
+            const auto sortedJetContents = sortMap(this->_pdgIds.toMap(this->_jetContents));
+            const auto sortedJetContentsByPT = sortMap(this->_pdgIds.toMap(this->_jetContentsByPT));
+
+            //Print and plot the jet contents
+            std::cout << std::endl << "Average multiplicity fraction of all jets in all events:" << std::endl << "----" << std::endl;
+            for(const std::pair<int, int> &particleCount: sortedJetContents){
+                const double fraction = 100.0 * particleCount.second / this->_totalNumberOfParticles;
+                std::cout << particleName(particleCount.first) << ": " << fraction << "%" << std::endl;
+            }
+
+            //Print the jet contents by pT
+            std::cout << std::endl << "Average pT-fraction of all jets in all events:" << std::endl << "----" << std::endl;
+            for(const std::pair<int, double> &particlePt: sortedJetContentsByPT){
+                std::cout << particleName(particlePt.first) << ": " << (100.0 * particlePt.second / this->_totalPT) << "%" << std::endl;
+            }
+
+            //Print the parents of photons and leptons (or the particles given in DECAY_PDGIDS)
+            for(PdgId child: this->_decayPdgIds){
+                const auto sortedParents = sortMap(this->_decays[child]);
+                const int numberOfChildren = this->_numberOfSampledDecays[child];
+                std::cout << std::endl << "Parent particles of " << particleName(child) << ":" << std::endl << "----" << std::endl;
+                for(const std::pair<Decay, int> &parentCount: sortedParents){
+                    const double fraction = 100.0 * parentCount.second / numberOfChildren;
+                    if(fraction < (child == PID::PHOTON ? 0.1 : 1)){
+                        break;
+                    }
+                    std::cout << parentCount.first << ": " << fraction << "%" << std::endl;
+                }
+            }
+
+            //Print the darkness
+            std::cout << std::endl;
+            std::cout << "Multiplicity fraction of particles with dark ancestors: " << (100.0 * this->_darkParticles / this->_totalNumberOfParticles) << "%" << std::endl;
+            std::cout << "pT-fraction of particles with dark ancestors: " << (100.0 * this->_darkPT / this->_totalPT) << "%" << std::endl;
+
+            //Print the substructure of the dark jets and the other jets
+            if(this->_substructure){
+                std::cout << std::endl << "Substructure of the jets with a pT-darkness above 50% and of the other jets:" << std::endl << "----" << std::endl;
+                this->_substructureSummary.print(getIntVectorFromEnvVar("PERCENTILES", std::vector<int>{10, 90}));
+            }
+            TIMING_WRITE_SUMMARY("JetContents");
+            this->_telemetry.finish();
+        }
+
+    private:
+        PdgIdRegistry _pdgIds;
+        std::vector<int> _jetContents;    //Indexed by the slot of the PDG ID in _pdgIds
+        std::vector<double> _jetContentsByPT;
+        int _darkParticles;
+        double _darkPT;
+        std::vector<bool> _trackDecays;    //Indexed by slot, true if the PDG ID is in _decayPdgIds
+        const std::vector<PdgId> _decayPdgIds;
+        const int _decaySampling;
+        long _decaySamplingCounter;
+        static constexpr double _jetRadius = 1.0;    //Of the jets and their substructure
+        const ClusteringOptions _clustering;
+        std::map<PdgId, std::map<Decay, int>> _decays;
+        std::map<PdgId, int> _numberOfSampledDecays;
+        int _totalNumberOfParticles;
+        double _totalPT;
+        bool _firstEvent;
+        DarknessRecombiner _darknessRecombiner;    //Has the clustered particles of the current event
+        const bool _substructure;
+        SubstructureCalculator _substructureCalculator;
+        SubstructureSummary _substructureSummary;    //Of all jets, only filled with SUBSTRUCTURE
+        Telemetry _telemetry;
+    };
+
+    DECLARE_RIVET_PLUGIN(JetContents);
 }
\ No newline at end of file
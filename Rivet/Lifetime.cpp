@@ -1,72 +1,106 @@
-#include <Rivet/Analysis.hh>
-#include <Rivet/Projections/FinalState.hh>
-#include <Rivet/Projections/ChargedFinalState.hh>
-#include <Rivet/Projections/FastJets.hh>
-#include <Rivet/Math/Vector4.hh>
-#include <TCanvas.h>
-#include <TH1D.h>
-#include <vector>
-#include <map>
-#include <algorithm>
-#include "../Headers/ParticleName.hpp"
-
-namespace Rivet{
-    class Lifetime: public Analysis{
-    public:
-        Lifetime(): Analysis("Lifetime"){}
-
-        virtual void init() override{}
-
-        virtual void analyze(const Event& event) override{
-            for(Particle particle: event.allParticles()){
-                //If the particle is stable on detector scales, we can't find its lifetime
-                if(particle.children().size() == 0){
-                    continue;
-                }
-
-                //If the particle just decays into itself, ignore it, we will use the last copy
-                if(particle.children().size() == 1 && particle.children()[0].pid() == particle.pid()){
-                    continue;
-                }
-
-                const double endTime = particle.children()[0].origin().t();
-                while(particle.parents().size() == 1 && particle.parents()[0].pid() == particle.pid()){
-                    particle = particle.parents()[0];
-                }
-                const double startTime = particle.origin().t();
-                const double lifetime = endTime - startTime;
-                if(lifetime > 0){
-                    this->_lifetimes[particle.abspid()].push_back(lifetime);
-                }
-            }
-        }
-
-        virtual void finalize() override{
-            const TString pdf = "../Outputs/Lifetime.pdf";
-            TCanvas canvas;
-            canvas.Print(pdf + "[");
-            for(const auto &particleLifetimePair: this->_lifetimes){
-                const PdgId pdgid = particleLifetimePair.first;
-                const std::vector<double> &lifetimes = particleLifetimePair.second;
-                const double maxLifetime = *std::max_element(lifetimes.begin(), lifetimes.end());
-                TH1D plot(
-                    "", (";Lifetime of #it{" + absParticleNameAsTLatex(pdgid) + "} (10^{-1} mm/c);Number of particles").c_str(),
-                    this->_bins, 0.0, maxLifetime    //x bins, min x, max x
-                );
-                for(double lifetime: lifetimes){
-                    plot.AddBinContent(lifetime * this->_bins / maxLifetime);
-                }
-                plot.SetStats(0);
-                plot.Draw("colz");
-                canvas.Print(pdf);
-            }
-            canvas.Print(pdf + "]");
-        }
-
-    private:
-        std::map<PdgId, std::vector<double>> _lifetimes;
-        static constexpr int _bins = 50;
-    };
-
-    DECLARE_RIVET_PLUGIN(Lifetime);
+#include <Rivet/Analysis.hh>
+#include <Rivet/Projections/FinalState.hh>
+#include <Rivet/Projections/ChargedFinalState.hh>
+#include <Rivet/Projections/FastJets.hh>
+#include <Rivet/Math/Vector4.hh>
+#include <TCanvas.h>
+#include <TH1D.h>
+#include <iostream>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include "../Headers/ParticleName.hpp"
+#include "../Headers/StreamingHistogram.hpp"
+#include "../Headers/Timing.hpp"
+#include "../Headers/Telemetry.hpp"
+
+namespace Rivet{
+    class Lifetime: public Analysis{
+    public:
+        Lifetime(): Analysis("Lifetime"), _telemetry("Lifetime"){}
+
+        virtual void init() override{}
+
+        virtual void analyze(const Event& event) override{
+            TIME_SCOPE("analyze");
+            TIMING_COUNT("events", 1);
+            this->_telemetry.event();
+            for(Particle particle: event.allParticles()){
+                //If the particle is stable on detector scales, we can't find its lifetime
+                if(particle.children().size() == 0){
+                    continue;
+                }
+
+                //If the particle just decays into itself, ignore it, we will use the last copy
+                if(particle.children().size() == 1 && particle.children()[0].pid() == particle.pid()){
+                    continue;
+                }
+
+                const double endTime = particle.children()[0].origin().t();
+                const double massOverEnergy = std::max(particle.mass(), 0.0) / particle.energy();    //Of the last copy, which is the one that decays
+#ifdef DARKJET_TIMING
+                std::size_t copies = 0;
+#endif
+                while(particle.parents().size() == 1 && particle.parents()[0].pid() == particle.pid()){
+                    particle = particle.parents()[0];
+#ifdef DARKJET_TIMING
+                    copies++;
+#endif
+                }
+                TIMING_RECORD("copies walked to the first copy", copies);
+                const double startTime = particle.origin().t();
+                const double lifetime = endTime - startTime;
+                if(lifetime > 0){
+                    LifetimeData &data = this->_lifetimes[particle.abspid()];
+                    data.histogram.fill(lifetime);
+                    data.lifetime.fill(lifetime);
+                    data.properLifetime.fill(lifetime * massOverEnergy);
+                }
+            }
+        }
+
+        virtual void finalize() override{
+            const TString pdf = "../Outputs/Lifetime.pdf";
+            TCanvas canvas;
+            canvas.Print(pdf + "[");
+            for(const auto &particleLifetimePair: this->_lifetimes){
+                const PdgId pdgid = particleLifetimePair.first;
+                const StreamingHistogram &lifetimes = particleLifetimePair.second.histogram;
+                //Only the bins up to the longest lifetime, which are between _bins and 2 * _bins bins from 0 to just above it
+                const int bins = lifetimes.usedBins();
+                TH1D plot(
+                    "", (";Lifetime of #it{" + absParticleNameAsTLatex(pdgid) + "} (10^{-1} mm/c);Number of particles").c_str(),
+                    bins, 0.0, lifetimes.range() * bins / lifetimes.bins()    //x bins, min x, max x
+                );
+                for(int i = 0; i < bins; i++){
+                    plot.SetBinContent(i + 1, lifetimes.binContent(i));
+                }
+                plot.SetStats(0);
+                plot.Draw("colz");
+                TIME_SCOPE("printing histograms");
+                canvas.Print(pdf);
+            }
+            canvas.Print(pdf + "]");
+
+            //Print the mean lifetimes
+            std::cout << std::endl << "Mean lifetime in the lab frame and mean proper lifetime (c*tau) (10^{-1} mm/c):" << std::endl << "----" << std::endl;
+            for(const auto &particleLifetimePair: this->_lifetimes){
+                const LifetimeData &data = particleLifetimePair.second;
+                std::cout << particleName(particleLifetimePair.first) << ": " << data.lifetime.mean() << " +- " << data.lifetime.standardError() << ", c*tau = " << data.properLifetime.mean() << " +- " << data.properLifetime.standardError() << " (" << data.lifetime.count() << " particles)" << std::endl;
+            }
+            TIMING_WRITE_SUMMARY("Lifetime");
+            this->_telemetry.finish();
+        }
+
+    private:
+        static constexpr int _bins = 50;
+        struct LifetimeData{
+            StreamingHistogram histogram{2 * _bins};    //The range is a power of two, so the longest lifetime can be just above half of it
+            RunningStatistics lifetime, properLifetime;
+        };
+        std::map<PdgId, LifetimeData> _lifetimes;
+        Telemetry _telemetry;
+    };
+
+    DECLARE_RIVET_PLUGIN(Lifetime);
 }
\ No newline at end of file
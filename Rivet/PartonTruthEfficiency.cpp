@@ -1,597 +1,1288 @@
-#include <Rivet/Analysis.hh>
-#include <Rivet/Projections/FinalState.hh>
-#include <Rivet/Projections/ChargedFinalState.hh>
-#include <Rivet/Projections/FastJets.hh>
-#include <Rivet/Math/Vector4.hh>
-#include <TCanvas.h>
-#include <TH1D.h>
-#include <TH2D.h>
-#include <iostream>
-#include <algorithm>
-#include <memory>
-#include "../Headers/Darkness.hpp"
-#include "../Headers/Decay.hpp"
-#include "../Headers/ParticleName.hpp"
-#include "../Headers/ParticleSort.hpp"
-#include "../Headers/GetEnvVars.hpp"
-#include "../Root/Legend.hpp"
-#include "PlotParticle.hpp"
-
-enum PlotColor{
-    NONE = 0,
-    PARTON = 1,
-    JET = 2,
-    CHARGE = 3,
-    TYPE = 4
-};
-
-namespace Rivet{
-    class PartonTruthEfficiency: public Analysis{
-    public:
-        PartonTruthEfficiency():
-            Analysis("PartonTruthEfficiency"),
-            _numberOfPlots(0),
-            _jetRadius(getDoubleFromEnvVar("JET_RADIUS", 1.0)),
-            _includeInvisibles(getIntFromEnvVar("INCLUDE_INVISIBLES", 1)),
-            _pdf(getStringFromEnvVar("PDF_FILENAME", TString("../Outputs/PartonTruthEfficiency.pdf"))),
-            _plotSecondChildren(getIntFromEnvVar("PLOT_SECOND_CHILDREN", 0)),
-            _pTFlow(
-                "", ";Rapidity #it{y};Azimuth #it{#phi};Jet #it{p}_{T} [GeV]",
-                200, -4, 4,    //y bins, min y, max y
-                157, 0, 2*M_PI    //phi bins, min phi, max phi
-            ),
-            _efficiencyData(this->_deltaRBins + 1),
-            _totalPT(0.0),
-            _purePT(0.0),
-            _responseSum(0.0),
-            _numberOfEventsWithResponse(0),
-            _partonPTPlot(
-                "", ";Parton #it{p_{T}} (GeV);Number of events",
-                this->_bins, 0.0, this->_maxPT/2    //x bins, min x, max x
-            ),
-            _partonInvariantMassPlot(
-                "", ";Di-parton invariant mass (GeV);Number of events",
-                this->_bins, 0.0, this->_maxPT    //x bins, min x, max x
-            ),
-            _jetResponsePlot(
-                "", ";Response (Particle level jet #it{p_{T}} / Parton #it{p_{T}});Number of events",
-                this->_bins, 0.0, this->_maxResponse    //x bins, min x, max x
-            ),
-            _fsResponsePlot(
-                "", ";#it{p_{T}} of final state children of parton / Parton #it{p_{T}};Number of events",
-                this->_bins, 0.0, this->_maxResponse*3/2    //x bins, min x, max x
-            ),
-            _fsInJetResponsePlot(
-                "", ";#it{p_{T}} of final state children of parton in particle level jet / Parton #it{p_{T}};Number of events",
-                this->_bins, 0.0, this->_maxResponse    //x bins, min x, max x
-            ),
-            _leadingJetPTPlot(
-                "", ";#it{p_{T}} of particle level jet (GeV);Number of events",
-                this->_bins, 0.0, this->_maxPT/2    //x bins, min x, max x
-            ),
-            _subLeadingJetPTPlot(
-                "", ";#it{p_{T}} of particle level jet (GeV);Number of events",
-                this->_bins, 0.0, this->_maxPT/2    //x bins, min x, max x
-            ),
-            _thirdLeadingJetPTPlot(
-                "", ";#it{p_{T}} of particle level jet (GeV);Number of events",
-                this->_bins, 0.0, this->_maxPT/2    //x bins, min x, max x
-            ),
-            _dijetInvariantMassPlot(
-                "", ";Truth dijet invariant mass (GeV);Number of events",
-                this->_bins, 0.0, this->_maxPT    //x bins, min x, max x
-            ),
-            _leadingJetInvisiblePlot(
-                "", ";Invisibility of particle level jet (%);Number of events",
-                this->_bins, 0.0, 100.0    //x bins, min x, max x
-            ),
-            _subLeadingJetInvisiblePlot(
-                "", ";Invisibility of particle level jet (%);Number of events",
-                this->_bins, 0.0, 100.0    //x bins, min x, max x
-            ),
-            _thirdLeadingJetInvisiblePlot(
-                "", ";Invisibility of particle level jet (%);Number of events",
-                this->_bins, 0.0, 100.0    //x bins, min x, max x
-            ),
-            _leadingJetDarknessPlot(
-                "", ";Darkness of particle level jet (%);Number of events",
-                this->_bins, 0.0, 100.0    //x bins, min x, max x
-            ),
-            _subLeadingJetDarknessPlot(
-                "", ";Darkness of particle level jet (%);Number of events",
-                this->_bins, 0.0, 100.0    //x bins, min x, max x
-            ),
-            _thirdLeadingJetDarknessPlot(
-                "", ";Darkness of particle level jet (%);Number of events",
-                this->_bins, 0.0, 100.0    //x bins, min x, max x
-            ),
-            _resonancePdgId(getIntVectorFromEnvVar("RES_PDGID", std::vector<int>{4900001, 4900023}))
-        {
-            this->_plotColor = static_cast<PlotColor>(getIntFromEnvVar("PLOT_COLOR", 1));
-            if(this->_plotColor < 0 || this->_plotColor > 4){
-                std::cout << "Invalid plot color " << this->_plotColor << ". Valid options are: (0) no color, (1) by parton, (2) by jet, (3) by charge, (4) by particle type." << std::endl;
-                this->_plotColor = PlotColor::NONE;
-            }
-        }
-
-        virtual void init() override{
-            const FinalState stableParticles;
-            this->declare(stableParticles, "FS");
-            this->declare(FastJets(stableParticles, FastJets::ANTIKT, this->_jetRadius, JetAlg::Muons::ALL, this->_includeInvisibles ? JetAlg::Invisibles::ALL : JetAlg::Invisibles::NONE), "Jets");
-
-            this->_canvas.Print(this->_pdf + "[");
-        }
-
-        virtual void analyze(const Event& event) override{
-            //Find the excited quark
-            const FinalState &finalState = this->apply<FinalState>(event, "FS");
-            const Jets &jets = this->apply<FastJets>(event, "Jets").jetsByPt();
-            const Jets &leadingJets = (this->_plotSecondChildren == 2) ? Jets{jets[0], jets[1], jets[2], jets[3]} : Jets{jets[0], jets[1]};
-            Particle excitedQuark;
-            for(const Particle &particle: event.allParticles()){
-                if(std::find(this->_resonancePdgId.begin(), this->_resonancePdgId.end(), particle.pid()) != this->_resonancePdgId.end()){
-                    excitedQuark = particle;
-                    break;
-                }
-            }
-            if(excitedQuark.pid() == PID::ANY){
-                std::cout << "Resonance particle not found." << std::endl;
-                return;
-            }
-            if(this->_plotSecondChildren == 2){
-                const int previousPdgId = excitedQuark.pid();
-                while(excitedQuark.pid() == previousPdgId){
-                    excitedQuark = excitedQuark.parents()[0];
-                }
-            }
-            while(excitedQuark.children().size() == 1){
-                excitedQuark = excitedQuark.children()[0];
-            }
-
-            //Count the decay mode of the particle
-            this->_numberOfParticles[excitedQuark.pid()]++;
-            this->_decays[excitedQuark.pid()][Decay::fromParent(excitedQuark)]++;
-
-            //Find the children of the particle
-            Particles plottedPartonLevelParticles, finalPartonLevelParticles;
-            for(Particle child: excitedQuark.children()){
-                plottedPartonLevelParticles.push_back(child);
-                if(this->_plotSecondChildren && (this->_plotSecondChildren == 2 || child.mass() > 50)){
-                    while(child.children().size() == 1){
-                        child = child.children()[0];
-                    }
-                    const Particles secondChildren = child.children();
-                    finalPartonLevelParticles.insert(finalPartonLevelParticles.end(), secondChildren.begin(), secondChildren.end());
-                    plottedPartonLevelParticles.insert(plottedPartonLevelParticles.end(), secondChildren.begin(), secondChildren.end());
-                }
-                else{
-                    finalPartonLevelParticles.push_back(child);
-                }
-            }
-
-            //Count the efficiency and purity of the jets
-            Jets remainingLeadingJets = leadingJets;
-            for(const Particle &parton: this->_plotSecondChildren == 2 ? finalPartonLevelParticles : excitedQuark.children()){
-                double deltaR = 1e6;    //Start with something that's guaranteed to be much larger than the actual deltaR
-                Jets::iterator jetIterator;
-                for(Jets::iterator newJet = remainingLeadingJets.begin(); newJet != remainingLeadingJets.end(); newJet++){
-                    const double deltaY = parton.rapidity() - newJet->rapidity();
-                    double deltaPhi = parton.phi() - newJet->phi();
-                    if(deltaPhi < -M_PI) deltaPhi += 2 * M_PI;
-                    else if(deltaPhi > M_PI) deltaPhi -= 2 * M_PI;
-                    const double newDeltaR = std::sqrt(deltaY * deltaY + deltaPhi * deltaPhi);
-                    if(newDeltaR < deltaR){
-                        deltaR = newDeltaR;
-                        jetIterator = newJet;
-                    }
-                }
-                const Jet jet = *jetIterator;
-                remainingLeadingJets.erase(jetIterator);
-
-                //Efficiency
-                for(int i = deltaR * this->_deltaRBins / this->_deltaRMax; i < this->_deltaRBins + 1; i++){
-                    this->_efficiencyData[i]++;
-                }
-
-                //Purity
-                for(const Particle &particle: jet.particles()){
-                    if(particleIsFromParton(particle, parton)){
-                        this->_purePT += particle.pT();
-                    }
-                    this->_totalPT += particle.pT();
-                }
-
-                //Plot the pT of the partons
-                if(parton.pT() < this->_maxPT){
-                    this->_partonPTPlot.Fill(parton.pT());
-                    if(!this->_partonPTPlotByType.count(parton.abspid())){
-                        this->_partonPTPlotByType.insert({parton.abspid(), std::shared_ptr<TH1D>(new TH1D(
-                            "", (";#it{p_{T}}(#it{" + absParticleNameAsTLatex(parton.abspid()) + "}) (GeV);Number of events").c_str(),
-                            this->_bins, 0.0, this->_maxPT    //x bins, min x, max x
-                        ))});
-                    }
-                    this->_partonPTPlotByType[parton.abspid()]->Fill(parton.pT());
-                }
-                double fsPT = 0.0, fsInJetPT = 0.0;
-                for(const Particle &particle: finalState.particles()){
-                    if(particleIsFromParton(particle, parton)){
-                        fsPT += particle.pT();
-                        if(jet.containsParticle(particle)){
-                            fsInJetPT += particle.pT();
-                        }
-                    }
-                }
-                if(deltaR <= this->_jetRadius){
-                    if(jet.pT() < parton.pT() * this->_maxResponse){
-                        this->_jetResponsePlot.Fill(jet.pT() / parton.pT());
-                        this->_responseSum += jet.pT() / parton.pT();
-                        this->_numberOfEventsWithResponse++;
-                    }
-                    if(fsInJetPT < parton.pT() * this->_maxResponse && fsInJetPT > 0){
-                        this->_fsInJetResponsePlot.Fill(fsInJetPT / parton.pT());
-                    }
-                }
-                if(fsPT < parton.pT() * this->_maxResponse && fsPT > 0){
-                    this->_fsResponsePlot.Fill(fsPT / parton.pT());
-                }
-            }
-
-            //Parton invariant mass
-            this->_partonInvariantMassPlot.Fill((excitedQuark.children()[0].momentum() + excitedQuark.children()[1].momentum()).mass());
-
-            //Jet pT and invariant mass
-            this->_leadingJetPTPlot.Fill(jets[0].pT());
-            this->_subLeadingJetPTPlot.Fill(jets[1].pT());
-            this->_thirdLeadingJetPTPlot.Fill(jets[2].pT());
-            this->_dijetInvariantMassPlot.Fill((jets[0].momentum() + jets[1].momentum()).mass());
-            
-            //Invisibility and darkness
-            this->_leadingJetInvisiblePlot.Fill(pTInvisibility(jets[0]) * 100.0);
-            this->_subLeadingJetInvisiblePlot.Fill(pTInvisibility(jets[1]) * 100.0);
-            this->_thirdLeadingJetInvisiblePlot.Fill(pTInvisibility(jets[2]) * 100.0);
-            this->_leadingJetDarknessPlot.Fill(pTDarkness(jets[0]) * 100.0);
-            this->_subLeadingJetDarknessPlot.Fill(pTDarkness(jets[1]) * 100.0);
-            this->_thirdLeadingJetDarknessPlot.Fill(pTDarkness(jets[2]) * 100.0);
-
-            //Jet multiplicity
-            int jetMultiplicity = 0, darkJetMultiplicity20 = 0, darkJetMultiplicity50 = 0, darkJetMultiplicity80 = 0;
-            for(const Jet &jet: jets){
-                if(jet.pT() < 100){
-                    break;
-                }
-                jetMultiplicity++;
-                const double darkness = pTDarkness(jet);
-                if(darkness > 0.2){
-                    darkJetMultiplicity20++;
-                }
-                if(darkness > 0.5){
-                    darkJetMultiplicity50++;
-                }
-                if(darkness > 0.8){
-                    darkJetMultiplicity80++;
-                }
-            }
-            this->_jetMultiplicityData[jetMultiplicity]++;
-            this->_darkJetMultiplicity20Data[darkJetMultiplicity20]++;
-            this->_darkJetMultiplicity50Data[darkJetMultiplicity50]++;
-            this->_darkJetMultiplicity80Data[darkJetMultiplicity80]++;
-
-            //Only plot the 10 events of each kind, but allow 20 events for decay modes that can be more interesting (W- or Z-bosons since they can decay further)
-            if(this->_decays[excitedQuark.pid()][Decay::fromParent(excitedQuark)] > (finalPartonLevelParticles.size() == 2 ? 10 : 20)){
-                return;
-            }
-
-            //Draw the axes
-            this->_pTFlow.Draw("colz");
-            this->_pTFlow.Reset();
-            this->_pTFlow.SetStats(0);
-
-            //Plot the jets
-            std::vector<int> jetColors;
-            for(const Jet &jet: leadingJets){
-                jetColors.push_back(particleColor(jet, jets, finalPartonLevelParticles));
-            }
-            const auto jetPolygons = plotJets(leadingJets, this->_jetRadius, jetColors);
-
-            //Plot the stable particles
-            for(const Particle &finalParticle: finalState.particles()){
-                int marker = 20;
-                if(!finalParticle.isVisible()){
-                    if(finalParticle.isNeutrino()){
-                        marker = 24;
-                    }
-                    else{    //Dark matter
-                        marker = 25;
-                    }
-                }
-                plotParticle(finalParticle, marker, particleColor(finalParticle, jets, finalPartonLevelParticles), false, 0.3);
-            }
-
-            //Plot the excited quark and its decay products
-            if(this->_plotSecondChildren != 2){
-                plotParticle(excitedQuark, 29);
-            }
-            for(const Particle &particle: plottedPartonLevelParticles){
-                const bool isXPrimeBoson = this->_plotSecondChildren == 2 && std::find_if(finalPartonLevelParticles.begin(), finalPartonLevelParticles.end(), [&particle](const Particle &parton){
-                    return particle.isSame(parton);
-                }) == finalPartonLevelParticles.end();
-                plotParticle(particle, isXPrimeBoson ? 29 : 20, this->_plotColor == PlotColor::PARTON ? particleColor(particle, jets, finalPartonLevelParticles) : EColor::kBlack);
-            }
-
-            //Print the page
-            this->_pTFlow.Draw("axis same");
-            drawTitle(&this->_pTFlow, this->title());
-            const std::vector<TString> &legends = this->_particleColorLegends.at(this->_plotColor);
-            const auto legend = drawLegend(&this->_pTFlow, (this->_plotColor == PlotColor::PARTON && this->_plotSecondChildren == 2) ? std::vector<int>{EColor::kOrange + 7, EColor::kAzure + 9} : this->_particleColors.at(this->_plotColor), (this->_plotColor == PlotColor::PARTON && this->_plotSecondChildren != 1) ? std::vector<TString>(legends.begin(), legends.end() - 1) : legends);
-            this->_canvas.Print(this->_pdf);
-        }
-
-        virtual void finalize() override{
-            //Plot the efficiency
-            TH1D efficiencyPlot(
-                "", ";#it{#Delta R};Efficiency between parton and particle level jet (%)",
-                this->_deltaRBins, 0.0, this->_deltaRMax    //x bins, min x, max x
-            );
-            for(int i = 0; i < this->_deltaRBins + 1; i++){
-                efficiencyPlot.AddBinContent(i, 50.0 * this->_efficiencyData[i] / this->numEvents());
-            }
-            this->plotHistogram(efficiencyPlot);
-
-            //Plot the pT and response
-            this->plotHistogram(this->_partonPTPlot);
-            for(const auto &pdgidPlotPair: this->_partonPTPlotByType){
-                this->plotHistogram(*pdgidPlotPair.second);
-            }
-            this->plotHistogram(this->_partonInvariantMassPlot);
-            this->plotHistogram(this->_jetResponsePlot);
-            this->plotHistogram(this->_fsResponsePlot);
-            this->plotHistogram(this->_fsInJetResponsePlot);
-            this->plotHistograms({&this->_leadingJetPTPlot, &this->_subLeadingJetPTPlot, &this->_thirdLeadingJetPTPlot}, std::vector<TString>{"Leading jet", "Subleading jet", "Third leading jet"});
-            this->plotHistogram(this->_dijetInvariantMassPlot);
-            if(this->_includeInvisibles){
-                this->plotHistograms({&this->_leadingJetInvisiblePlot, &this->_subLeadingJetInvisiblePlot, &this->_thirdLeadingJetInvisiblePlot}, std::vector<TString>{"Leading jet", "Subleading jet", "Third leading jet"});
-            }
-            this->plotHistograms({&this->_leadingJetDarknessPlot, &this->_subLeadingJetDarknessPlot, &this->_thirdLeadingJetDarknessPlot}, std::vector<TString>{"Leading jet", "Subleading jet", "Third leading jet"});
-
-            //Plot the jet multiplicity
-            const int maxMultiplicity = std::max_element(this->_jetMultiplicityData.begin(), this->_jetMultiplicityData.end(), [](const std::pair<int, int> &a, const std::pair<int, int> &b){return a.first < b.first;})->first;
-            TH1D darkJetMultiplicity80Plot(
-                "", ";Particle level jet multiplicity;Number of events",
-                maxMultiplicity * 2 + 2, 0.0, maxMultiplicity + 1    //x bins, min x, max x
-            ),
-            &darkJetMultiplicity50Plot = *static_cast<TH1D*>(darkJetMultiplicity80Plot.Clone()),
-            &darkJetMultiplicity20Plot = *static_cast<TH1D*>(darkJetMultiplicity80Plot.Clone()),
-            &jetMultiplicityPlot = *static_cast<TH1D*>(darkJetMultiplicity80Plot.Clone());
-            for(const auto &multiplicityEventsPair: this->_jetMultiplicityData){
-                jetMultiplicityPlot.Fill(multiplicityEventsPair.first - 0.1, multiplicityEventsPair.second);
-                jetMultiplicityPlot.Fill(multiplicityEventsPair.first + 0.1, multiplicityEventsPair.second);
-            }
-            for(const auto &multiplicityEventsPair: this->_darkJetMultiplicity20Data){
-                darkJetMultiplicity20Plot.Fill(multiplicityEventsPair.first - 0.1, multiplicityEventsPair.second);
-                darkJetMultiplicity20Plot.Fill(multiplicityEventsPair.first + 0.1, multiplicityEventsPair.second);
-            }
-            for(const auto &multiplicityEventsPair: this->_darkJetMultiplicity50Data){
-                darkJetMultiplicity50Plot.Fill(multiplicityEventsPair.first - 0.1, multiplicityEventsPair.second);
-                darkJetMultiplicity50Plot.Fill(multiplicityEventsPair.first + 0.1, multiplicityEventsPair.second);
-            }
-            for(const auto &multiplicityEventsPair: this->_darkJetMultiplicity80Data){
-                darkJetMultiplicity80Plot.Fill(multiplicityEventsPair.first - 0.1, multiplicityEventsPair.second);
-                darkJetMultiplicity80Plot.Fill(multiplicityEventsPair.first + 0.1, multiplicityEventsPair.second);
-            }
-            this->plotHistograms({&jetMultiplicityPlot, &darkJetMultiplicity20Plot, &darkJetMultiplicity50Plot, &darkJetMultiplicity80Plot}, std::vector<TString>{"All jets", "#it{f}_{dark} > 0.2", "#it{f}_{dark} > 0.5", "#it{f}_{dark} > 0.8"}, ", p_{T} cut = 100 GeV");
-
-            //Close the plot
-            this->_canvas.Print(this->_pdf + "]");
-
-            //Print the decay modes
-            for(PdgId parent: this->_resonancePdgId){
-                const auto decays = sortMap(this->_decays[parent]);
-                std::cout << std::endl << "Decay modes of " << particleName(parent) << ":" << std::endl << "----" << std::endl;
-                for(const std::pair<Decay, int> &decayCount: decays){
-                    std::cout << decayCount.first << ": " << (100.0 * decayCount.second / this->_numberOfParticles[parent]) << "%" << std::endl;
-                }
-            }
-
-            //Print the efficiency, purity and response
-            std::cout << std::endl;
-            std::cout << "Purity: " << (100.0 * this->_purePT / this->_totalPT) << "%" << std::endl;
-            std::cout << "Efficiency at DeltaR = R: " << ((this->_plotSecondChildren == 2 ? 25.0 : 50.0) * this->_efficiencyData[this->_efficiencyData.size() * this->_jetRadius / this->_deltaRMax] / this->numEvents()) << "%" << std::endl;
-            std::cout << "Average response: " << (this->_responseSum / this->_numberOfEventsWithResponse) << std::endl;
-        }
-
-    private:
-        TString title(const TString &extraLabel = "") const{
-            const TString model = modelName(this->_pdf);
-            TString process;
-            if(model.BeginsWith("EJ")){
-                process = "X' #bar{X}' #rightarrow q #bar{q}_{D} #bar{q} q_{D}";
-            }
-            else{
-                process = "Z' #rightarrow q_{D} #bar{q}_{D}";
-            }
-            return "Anti-#it{k_{t}}, #it{R} = " + std::regex_replace(std::to_string(this->_jetRadius), std::regex("([1-9]|\\.0)0+$"), "$1") + ", " + (this->_includeInvisibles ? "with" : "without") + " invisibles" + extraLabel + "\nModel " + model + ", " + process;
-        }
-
-        void plotHistogram(TH1D &histogram){
-            histogram.SetStats(0);
-            histogram.Draw("colz");
-            drawTitle(&histogram, this->title());
-            this->_canvas.Print(this->_pdf);
-        }
-
-        void plotHistograms(std::vector<TH1D*> histograms, const std::vector<TString> &legends, const TString &extraLabel = ""){
-            for(std::size_t i = 1; i < histograms.size() && i < this->_lineColors.size() + 1; i++){
-                histograms[i]->SetLineColor(this->_lineColors[i - 1]);
-            }
-            std::sort(histograms.begin(), histograms.end(), [](const TH1D *a, const TH1D *b){
-                return a->GetMaximum() > b->GetMaximum();
-            });
-            bool first = true;
-            for(TH1D *histogram: histograms){
-                histogram->SetStats(0);
-                histogram->Draw(first ? "hist" : "histsame");
-                first = false;
-            }
-            drawTitle(histograms[0], this->title(extraLabel));
-            const auto legend = drawLegend(histograms[0], this->_lineColors, legends);
-            this->_canvas.Print(this->_pdf);
-        }
-
-        static bool particleIsFromParton(Particle particle, const Particle &parton){
-            while(particle.parents().size() > 0){
-                if(particle.isSame(parton)){
-                    return true;
-                }
-                particle = particlesByEnergy(particle.parents())[0];
-            }
-            return false;
-        }
-
-        int particleColor(const ParticleBase &particleOrJet, const Jets &jets, const Particles &finalPartonLevelParticles){
-            const Particle *particle = dynamic_cast<const Particle*>(&particleOrJet);
-            const Jet *jet = dynamic_cast<const Jet*>(&particleOrJet);
-            std::vector<int> colors = this->_particleColors.at(this->_plotColor);
-            switch(this->_plotColor){
-            case PlotColor::PARTON:
-                {
-                    const Particles sortedFinalPartonLevelParticles = particlesByEnergy(finalPartonLevelParticles);
-                    if(this->_plotSecondChildren == 2){
-                        if(sortedFinalPartonLevelParticles.size() >= 4){
-                            colors.erase(colors.begin() + 2);
-                            if(sortedFinalPartonLevelParticles[0].parents()[0].isSame(sortedFinalPartonLevelParticles[3].parents()[0]) && sortedFinalPartonLevelParticles[1].parents()[0].isSame(sortedFinalPartonLevelParticles[2].parents()[0])){
-                                std::iter_swap(colors.begin() + 2, colors.begin() + 3);
-                            }
-                            else if(sortedFinalPartonLevelParticles[0].parents()[0].isSame(sortedFinalPartonLevelParticles[1].parents()[0]) && sortedFinalPartonLevelParticles[2].parents()[0].isSame(sortedFinalPartonLevelParticles[3].parents()[0])){
-                                std::iter_swap(colors.begin() + 1, colors.begin() + 2);
-                            }
-                        }
-                    }
-                    for(Particle parentParticle: (jet ? particlesByEnergy(jet->particles()) : Particles{*particle})){
-                        while(parentParticle.parents().size() > 0){
-                            for(unsigned int i = 0; i < sortedFinalPartonLevelParticles.size() && i < colors.size(); i++){
-                                Particle parton = sortedFinalPartonLevelParticles[i];
-                                if(parentParticle.isSame(parton)){
-                                    return colors[i] + (jet ? (colors[i] == EColor::kOrange - 3 ? -1 : -9) : 0);
-                                }
-                            }
-                            parentParticle = particlesByEnergy(parentParticle.parents())[0];
-                        }
-                    }
-                    if(this->_plotSecondChildren == 2 && particle != nullptr){
-                        Particle currentParticle = *particle;
-                        while(currentParticle.children().size() == 1){
-                            currentParticle = currentParticle.children()[0];
-                        }
-                        if(sortedFinalPartonLevelParticles[0].parents()[0].isSame(currentParticle)){
-                            return EColor::kOrange + 7;
-                        }
-                        else for(const Particle &finalPartonLevelParticle: sortedFinalPartonLevelParticles){
-                            if(finalPartonLevelParticle.parents()[0].isSame(currentParticle)){
-                                return EColor::kAzure + 9;
-                            }
-                        }
-                    }
-                }
-                break;
-            case PlotColor::JET:
-                for(const std::pair<Jet, int> &jetColorPair: this->_plotSecondChildren == 2 ? std::vector<std::pair<Jet, int>>{{jets[0], colors[0]}, {jets[1], colors[1]}, {jets[2], colors[2]}, {jets[3], colors[3]}} : std::vector<std::pair<Jet, int>>{{jets[0], colors[0]}, {jets[1], colors[1]}}){
-                    if(jet != nullptr && jet->size() == jetColorPair.first.size() && jet->momentum() == jetColorPair.first.momentum()){
-                        return jetColorPair.second - 9;
-                    }
-                    else if(particle != nullptr && jetColorPair.first.containsParticle(*particle)){
-                        return jetColorPair.second;
-                    }
-                }
-                break;
-            case PlotColor::CHARGE:
-                if(particle != nullptr){
-                    return colors[1 - (particle->charge3() > 0) + (particle->charge3() < 0)];
-                }
-                break;
-            case PlotColor::TYPE:
-                //Jets
-                if(jet != nullptr){
-                    return colors[0];
-                }
-                //Partons
-                else if(particle->abspid() < 10 || particle->abspid() == 21){
-                    return colors[1];
-                }
-                //Bosons (excluding gluons)
-                else if(particle->abspid() / 10 == 2){
-                    return colors[2];
-                }
-                //Leptons
-                else if(particle->abspid() / 10 == 1){
-                    return colors[3];
-                }
-                //Mesons
-                else if(particle->abspid() >= 100 && particle->abspid() < 1000){
-                    return colors[4];
-                }
-                //Baryons or diquarks
-                else if(particle->abspid() >= 1000 && particle->abspid() < 10000){
-                    //Diquarks
-                    if(particle->abspid() % 100 < 10){
-                        return colors[5];
-                    }
-                    //Baryons
-                    else{
-                        return colors[6];
-                    }
-                }
-                //Unknown particles
-                break;
-            }
-            return jet ? EColor::kGray : EColor::kBlack;
-        }
-
-        int _numberOfPlots;
-        std::map<PdgId, int> _numberOfParticles;
-        std::map<PdgId, std::map<Decay, int>> _decays;
-
-        const double _jetRadius;
-        const bool _includeInvisibles;
-        const TString _pdf;
-        const int _plotSecondChildren;
-        TCanvas _canvas;
-        TH2D _pTFlow;
-
-        static constexpr int _deltaRBins = 20;
-        static constexpr double _deltaRMax = 2.0;
-        std::vector<double> _efficiencyData;
-        double _totalPT, _purePT;
-        double _responseSum;
-        int _numberOfEventsWithResponse;
-        std::map<int, int> _jetMultiplicityData;    //Contains the number of jets with pT > 30GeV as key, and the number of events with that key as value
-        std::map<int, int> _darkJetMultiplicity20Data, _darkJetMultiplicity50Data, _darkJetMultiplicity80Data;    //Same as above but only counts jets with darkness > 20% / 50% / 80%
-
-        static constexpr int _bins = 50;
-        static constexpr double _maxPT = 3e3;
-        static constexpr double _maxResponse = 2.0;
-        TH1D _partonPTPlot, _partonInvariantMassPlot, _jetResponsePlot, _fsResponsePlot, _fsInJetResponsePlot;
-        std::map<PdgId, std::shared_ptr<TH1D>> _partonPTPlotByType;
-        TH1D _leadingJetPTPlot, _subLeadingJetPTPlot, _thirdLeadingJetPTPlot, _dijetInvariantMassPlot;
-        TH1D _leadingJetInvisiblePlot, _subLeadingJetInvisiblePlot, _thirdLeadingJetInvisiblePlot, _leadingJetDarknessPlot, _subLeadingJetDarknessPlot, _thirdLeadingJetDarknessPlot;
-
-        const std::vector<PdgId> _resonancePdgId;
-        const std::vector<int> _lineColors{EColor::kOrange - 3, EColor::kGreen + 2, EColor::kMagenta + 2};
-        const std::map<PlotColor, std::vector<int>> _particleColors{
-            {PlotColor::PARTON, std::vector<int>{EColor::kRed, EColor::kBlue, EColor::kGreen + 2, EColor::kOrange - 3, EColor::kCyan + 2}},
-            {PlotColor::JET, std::vector<int>{EColor::kRed, EColor::kBlue, EColor::kGreen + 2, EColor::kMagenta + 2}},
-            {PlotColor::CHARGE, std::vector<int>{EColor::kRed, EColor::kBlue + 1, EColor::kGreen + 1}},
-            {PlotColor::TYPE, std::vector<int>{EColor::kBlue - 9, EColor::kMagenta + 2, EColor::kOrange, EColor::kGreen + 1, EColor::kRed, EColor::kPink + 7, EColor::kRed + 2}},
-            {PlotColor::NONE, std::vector<int>{}}
-        };
-        const std::map<PlotColor, std::vector<TString>> _particleColorLegends{
-            {PlotColor::PARTON, std::vector<TString>{"Leading parton & children", "Subleading parton & children", "Third leading parton & children"}},
-            {PlotColor::JET, std::vector<TString>{"Leading jet", "Subleading jet"}},
-            {PlotColor::CHARGE, std::vector<TString>{"Positive", "Neutral", "Negative"}},
-            {PlotColor::TYPE, std::vector<TString>{"Jet", "Parton", "Boson", "Lepton", "Meson", "Diquark", "Baryon"}},
-            {PlotColor::NONE, std::vector<TString>{}}
-        };
-        PlotColor _plotColor;
-    };
-
-    DECLARE_RIVET_PLUGIN(PartonTruthEfficiency);
+#include <Rivet/Analysis.hh>
+#include <Rivet/Projections/FinalState.hh>
+#include <Rivet/Projections/ChargedFinalState.hh>
+#include <Rivet/Projections/VisibleFinalState.hh>
+#include <Rivet/Projections/FastJets.hh>
+#include <Rivet/Math/Vector4.hh>
+#include <TCanvas.h>
+#include <TH1D.h>
+#include <TH2D.h>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <memory>
+#include <deque>
+#include <future>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <stdexcept>
+#include "../Headers/DarknessRivet.hpp"
+#include "../Headers/Decay.hpp"
+#include "../Headers/ParticleName.hpp"
+#include "../Headers/ParticleSortRivet.hpp"
+#include "../Headers/ParticleHandle.hpp"
+#include "../Headers/GetEnvVars.hpp"
+#include "../Headers/Timing.hpp"
+#include "../Headers/Telemetry.hpp"
+#include "../Headers/WorkStealingPool.hpp"
+#include "../Headers/CheckpointRoot.hpp"
+#include "../Headers/Bootstrap.hpp"
+#include "../Headers/QuantileSketch.hpp"
+#include "../Headers/PreSelection.hpp"
+#include "../Headers/PileUpRivet.hpp"
+#include "../Headers/Substructure.hpp"
+#include "../Headers/MultiWeight.hpp"
+#include "../Headers/JetCompositionRivet.hpp"
+#include "../Headers/JetClusteringRivet.hpp"
+#include "../Headers/CompactGenealogy.hpp"
+#include "../Root/Legend.hpp"
+#include "../Root/ParallelPlot.hpp"
+#include "PlotParticle.hpp"
+
+enum PlotColor{
+    NONE = 0,
+    PARTON = 1,
+    JET = 2,
+    CHARGE = 3,
+    TYPE = 4
+};
+
+namespace Rivet{
+    class PartonTruthEfficiency: public Analysis{
+    public:
+        PartonTruthEfficiency():
+            Analysis("PartonTruthEfficiency"),
+            _numberOfPlots(0),
+            _jetRadius(getDoubleFromEnvVar("JET_RADIUS", 1.0)),
+            _includeInvisibles(getIntFromEnvVar("INCLUDE_INVISIBLES", 1)),
+            _pdf(getStringFromEnvVar("PDF_FILENAME", TString("../Outputs/PartonTruthEfficiency.pdf"))),
+            _plotSecondChildren(getIntFromEnvVar("PLOT_SECOND_CHILDREN", 0)),
+            _pTFlow(
+                "", ";Rapidity #it{y};Azimuth #it{#phi};Jet #it{p}_{T} [GeV]",
+                200, -4, 4,    //y bins, min y, max y
+                157, 0, 2*M_PI    //phi bins, min phi, max phi
+            ),
+            _efficiencyData(this->_deltaRBins + 1),
+            _totalPT(0.0),
+            _purePT(0.0),
+            _responseSum(0.0),
+            _numberOfEventsWithResponse(0),
+            _bootstrapReplicas(getIntFromEnvVar("BOOTSTRAP_REPLICAS", 0)),
+            _bootstrapPurity(this->_bootstrapReplicas),
+            _bootstrapEfficiency(this->_bootstrapReplicas),
+            _bootstrapResponse(this->_bootstrapReplicas),
+            _weightVariations(getIntFromEnvVar("WEIGHT_VARIATIONS", 0)),
+            _weightsFile(getStringFromEnvVar("WEIGHTS_FILE", std::string("../Outputs/PartonTruthEfficiencyWeights.tsv"))),
+            _percentiles(getIntVectorFromEnvVar("PERCENTILES", std::vector<int>{10, 90})),
+            _jetDarknessSketches(3),
+            _darknessRecombiner(clusterParticlesFirstIndex),
+            _substructure(getIntFromEnvVar("SUBSTRUCTURE", 0)),
+            _substructureCalculator(this->_jetRadius),
+            _partonPTPlot(
+                "", ";Parton #it{p_{T}} (GeV);Number of events",
+                this->_bins, 0.0, this->_maxPT/2    //x bins, min x, max x
+            ),
+            _partonInvariantMassPlot(
+                "", ";Di-parton invariant mass (GeV);Number of events",
+                this->_bins, 0.0, this->_maxPT    //x bins, min x, max x
+            ),
+            _jetResponsePlot(
+                "", ";Response (Particle level jet #it{p_{T}} / Parton #it{p_{T}});Number of events",
+                this->_bins, 0.0, this->_maxResponse    //x bins, min x, max x
+            ),
+            _fsResponsePlot(
+                "", ";#it{p_{T}} of final state children of parton / Parton #it{p_{T}};Number of events",
+                this->_bins, 0.0, this->_maxResponse*3/2    //x bins, min x, max x
+            ),
+            _fsInJetResponsePlot(
+                "", ";#it{p_{T}} of final state children of parton in particle level jet / Parton #it{p_{T}};Number of events",
+                this->_bins, 0.0, this->_maxResponse    //x bins, min x, max x
+            ),
+            _leadingJetPTPlot(
+                "", ";#it{p_{T}} of particle level jet (GeV);Number of events",
+                this->_bins, 0.0, this->_maxPT/2    //x bins, min x, max x
+            ),
+            _subLeadingJetPTPlot(
+                "", ";#it{p_{T}} of particle level jet (GeV);Number of events",
+                this->_bins, 0.0, this->_maxPT/2    //x bins, min x, max x
+            ),
+            _thirdLeadingJetPTPlot(
+                "", ";#it{p_{T}} of particle level jet (GeV);Number of events",
+                this->_bins, 0.0, this->_maxPT/2    //x bins, min x, max x
+            ),
+            _dijetInvariantMassPlot(
+                "", ";Truth dijet invariant mass (GeV);Number of events",
+                this->_bins, 0.0, this->_maxPT    //x bins, min x, max x
+            ),
+            _leadingJetInvisiblePlot(
+                "", ";Invisibility of particle level jet (%);Number of events",
+                this->_bins, 0.0, 100.0    //x bins, min x, max x
+            ),
+            _subLeadingJetInvisiblePlot(
+                "", ";Invisibility of particle level jet (%);Number of events",
+                this->_bins, 0.0, 100.0    //x bins, min x, max x
+            ),
+            _thirdLeadingJetInvisiblePlot(
+                "", ";Invisibility of particle level jet (%);Number of events",
+                this->_bins, 0.0, 100.0    //x bins, min x, max x
+            ),
+            _leadingJetDarknessPlot(
+                "", ";Darkness of particle level jet (%);Number of events",
+                this->_bins, 0.0, 100.0    //x bins, min x, max x
+            ),
+            _subLeadingJetDarknessPlot(
+                "", ";Darkness of particle level jet (%);Number of events",
+                this->_bins, 0.0, 100.0    //x bins, min x, max x
+            ),
+            _thirdLeadingJetDarknessPlot(
+                "", ";Darkness of particle level jet (%);Number of events",
+                this->_bins, 0.0, 100.0    //x bins, min x, max x
+            ),
+            _resonancePdgId(getIntVectorFromEnvVar("RES_PDGID", std::vector<int>{4900001, 4900023})),
+            _preSelection(this->_resonancePdgId, this->_plotSecondChildren),
+            _pileUp(pileUpPoolFromEnvVars()),
+            _telemetry("PartonTruthEfficiency"),
+            _parallelJobs(getIntFromEnvVar("PARALLEL_JOBS", 1)),
+            _compactGenealogy(getIntFromEnvVar("COMPACT_GENEALOGY", 1)),
+            _checkpointInterval(getDoubleFromEnvVar("CHECKPOINT_INTERVAL", 0.0)),
+            _checkpointFile(getStringFromEnvVar("CHECKPOINT_FILE", std::string("../Outputs/PartonTruthEfficiencyCheckpoint.bin"))),
+            _resume(getIntFromEnvVar("RESUME", 0)),
+            _eventsSeen(0),
+            _eventsToSkip(0),
+            _lastEventNumber(-1),
+            _eventsWithTooFewJets(0),
+            _pdfParts(0),
+            _pagesInPart(0)
+        {
+            this->_plotColor = static_cast<PlotColor>(getIntFromEnvVar("PLOT_COLOR", 1));
+            if(this->_plotColor < 0 || this->_plotColor > 4){
+                std::cout << "Invalid plot color " << this->_plotColor << ". Valid options are: (0) no color, (1) by parton, (2) by jet, (3) by charge, (4) by particle type." << std::endl;
+                this->_plotColor = PlotColor::NONE;
+            }
+        }
+
+        virtual void init() override{
+            const FinalState stableParticles;
+            this->declare(stableParticles, "FS");
+            const FinalState clusteredParticles(particleCut(this->_clustering));    //The whole final state unless MAX_PARTICLE_ETA is set
+            this->declare(clusteredParticles, "ClusteredFS");
+            this->declare(VisibleFinalState(clusteredParticles), "VFS");    //The particles that are clustered without INCLUDE_INVISIBLES
+
+            if(this->_resume){
+                this->readCheckpoint();
+            }
+            this->_pagePdf = this->_checkpointInterval > 0 ? this->pdfPart(this->_pdfParts) : this->_pdf;
+            this->_canvas.Print(this->_pagePdf + "[");
+            this->_lastCheckpoint = std::chrono::steady_clock::now();
+            if(this->_parallelJobs > 1){
+                this->_pool.reset(new WorkStealingPool(this->_parallelJobs));
+            }
+        }
+
+        virtual void analyze(const Event& event) override{
+            TIME_SCOPE("analyze");
+            this->_telemetry.event();
+            if(this->_checkpointInterval > 0 && this->_eventsSeen > this->_eventsToSkip && std::chrono::steady_clock::now() - this->_lastCheckpoint >= std::chrono::duration<double>(this->_checkpointInterval)){
+                this->writeCheckpoint();
+            }
+
+            //When resuming, skip the events that are already in the checkpoint
+            this->_eventsSeen++;
+            if(this->_eventsSeen <= this->_eventsToSkip){
+                if(this->_eventsSeen == this->_eventsToSkip && event.genEvent()->event_number() != this->_lastEventNumber){
+                    std::cout << "Warning: the last event in the checkpoint has event number " << this->_lastEventNumber << ", but event " << this->_eventsSeen << " of the input has event number " << event.genEvent()->event_number() << ". Is this the same input as before?" << std::endl;
+                }
+                this->_telemetry.count("events skipped");
+                return;
+            }
+            this->_lastEventNumber = event.genEvent()->event_number();
+            TIMING_COUNT("events", 1);
+
+            //All weights of the event, only used with WEIGHT_VARIATIONS
+            std::vector<double> weights;
+            if(this->_weightVariations){
+                weights = eventWeights(*event.genEvent());
+                if(this->_weightNames.empty()){
+                    this->setWeightNames(eventWeightNames(*event.genEvent()));
+                }
+                else if(weights.size() != this->_weightNames.size()){
+                    std::cout << "Warning: event " << this->_lastEventNumber << " has " << weights.size() << " weights, but the first event had " << this->_weightNames.size() << ". Only the weights both have are filled." << std::endl;
+                }
+            }
+
+            //Copy what the genealogy walks need out of the event, so that they can run on the worker threads after analyze returns. Without worker threads the snapshot is analysed before analyze returns, so the same one is reused for every event, which keeps the memory of its arrays.
+            const std::shared_ptr<EventSnapshot> snapshot = this->_pool ? std::make_shared<EventSnapshot>() : this->_reusedSnapshot;
+            snapshot->clear();
+            snapshot->number = this->_eventsSeen;
+            snapshot->weights = weights;
+            //With COMPACT_GENEALOGY the whole genealogy is copied first, and only compacted into the snapshot once the event passed the pre-selection. Either way the pre-selection runs on the whole genealogy, where particle i is the GenParticle with id i + 1.
+            FlatEventStorage &fullGenealogy = this->_compactGenealogy ? this->_fullGenealogy : snapshot->genealogy;
+            {
+                TIME_SCOPE("copying the genealogy");
+                fullGenealogy.fill(*event.genEvent());
+            }
+
+            //Reject the events without a resonance particle, and those that fail the other truth-level cuts, before the genealogy is compacted and before any projection is applied
+            FlatParticle resonance;
+            {
+                TIME_SCOPE("pre-selection");
+                const std::size_t cutsPassed = this->_preSelection.apply(fullGenealogy.view(), this->_cutflow, resonance);
+                if(cutsPassed == 0){
+                    std::cout << "Resonance particle not found." << std::endl;
+                    TIMING_COUNT("events without resonance", 1);
+                    this->_telemetry.count("events without resonance");
+                }
+                else if(cutsPassed < this->_preSelection.cuts()){
+                    this->_telemetry.count("events rejected by the pre-selection");
+                }
+                if(cutsPassed < this->_preSelection.cuts()){
+                    this->fillEventTotals(this->_eventsSeen, weights, 0.0, 0.0, 0, 0.0, 0);    //The event still counts towards the efficiency
+                    return;
+                }
+            }
+            if(this->_compactGenealogy){
+                TIME_SCOPE("copying the genealogy");
+                this->_compactedIndices = compactGenealogy(this->_fullGenealogy.view(), particlesToKeep(this->_fullGenealogy.view(), this->_resonancePdgId), snapshot->genealogy);
+            }
+
+            const FinalState &finalState = this->apply<FinalState>(event, "FS");
+            {
+                TIME_SCOPE("taking the event snapshot");
+                for(const Particle &particle: finalState.particles()){
+                    snapshot->finalState.push_back(flatIndex(particle));
+                    snapshot->finalStatePT.push_back(particle.pT());
+                }
+            }
+
+            //Cluster the jets with the DarknessRecombiner of this analysis, which adds up the darkness of the jets while they are merged, with the dark ancestry of all particles found in one pass over the genealogy
+            //With pile-up the overlaid particles are added to the clustered particles. They have no GenParticle, so they are neither dark nor from a parton.
+            Jets jets;
+            {
+                TIME_SCOPE_PER_CALL("clustering");
+                const std::vector<bool> dark = particlesWithDarkAncestor(snapshot->genealogy.view());
+                Particles clusteredParticles = this->apply<FinalState>(event, this->_includeInvisibles ? "ClusteredFS" : "VFS").particles();
+                if(this->_pileUp){
+                    for(const Particle &particle: pileUpParticles(*this->_pileUp, this->_eventsSeen)){
+                        if((this->_includeInvisibles || particle.isVisible()) && particleIsClustered(particle.eta(), this->_clustering)){
+                            clusteredParticles.push_back(particle);
+                        }
+                    }
+                }
+                TIMING_COUNT("clustered particles", clusteredParticles.size());
+                setJetCompositionInputs(this->_darknessRecombiner, clusteredParticles, [this, &dark](const Particle &particle){
+                    const int index = this->flatIndex(particle);
+                    return index >= 0 ? dark[index] : pdgIdIsDark(particle.pid());
+                });
+                jets = clusterParticles(clusteredParticles, this->_darknessRecombiner.jetDefinition(fastjet::antikt_algorithm, this->_jetRadius, this->_clustering.strategy), jetCut(this->_clustering));
+                keepLeadingJets(jets, this->_clustering);
+            }
+            if(jets.size() < (this->_plotSecondChildren == 2 ? 4 : 3)){    //Can happen with MIN_JET_PT, MAX_JET_ETA or MAX_JETS
+                TIMING_COUNT("events with too few jets", 1);
+                this->_telemetry.count("events with too few jets");
+                this->_eventsWithTooFewJets++;
+                this->fillEventTotals(this->_eventsSeen, weights, 0.0, 0.0, 0, 0.0, 0);    //The event still counts towards the efficiency
+                return;
+            }
+
+            //The excited quark is the resonance the pre-selection found, in the whole genealogy
+            const Jets &leadingJets = (this->_plotSecondChildren == 2) ? Jets{jets[0], jets[1], jets[2], jets[3]} : Jets{jets[0], jets[1]};
+            const Particle excitedQuark(event.genEvent()->particles()[resonance.index()]);
+
+            //Count the decay mode of the particle
+            int numberOfEventsWithDecay;
+            {
+                TIME_SCOPE("decay bookkeeping");
+                this->_numberOfParticles[excitedQuark.pid()]++;
+                numberOfEventsWithDecay = ++this->_decays[excitedQuark.pid()][Decay::fromParent(excitedQuark)];
+            }
+
+            //Find the children of the particle
+            Particles plottedPartonLevelParticles, finalPartonLevelParticles;
+            for(Particle child: excitedQuark.children()){
+                plottedPartonLevelParticles.push_back(child);
+                if(this->_plotSecondChildren && (this->_plotSecondChildren == 2 || child.mass() > 50)){
+                    while(child.children().size() == 1){
+                        child = child.children()[0];
+                    }
+                    const Particles secondChildren = child.children();
+                    finalPartonLevelParticles.insert(finalPartonLevelParticles.end(), secondChildren.begin(), secondChildren.end());
+                    plottedPartonLevelParticles.insert(plottedPartonLevelParticles.end(), secondChildren.begin(), secondChildren.end());
+                }
+                else{
+                    finalPartonLevelParticles.push_back(child);
+                }
+            }
+
+            //Match the partons to the jets, the efficiency and purity are counted in applyResult
+            Jets remainingLeadingJets = leadingJets;
+            for(const Particle &parton: this->_plotSecondChildren == 2 ? finalPartonLevelParticles : excitedQuark.children()){
+                if(remainingLeadingJets.empty()){
+                    break;
+                }
+                TIME_SCOPE("matching partons to jets");
+                double deltaR = 1e6;    //Start with something that's guaranteed to be much larger than the actual deltaR
+                Jets::iterator jetIterator;
+                for(Jets::iterator newJet = remainingLeadingJets.begin(); newJet != remainingLeadingJets.end(); newJet++){
+                    const double deltaY = parton.rapidity() - newJet->rapidity();
+                    double deltaPhi = parton.phi() - newJet->phi();
+                    if(deltaPhi < -M_PI) deltaPhi += 2 * M_PI;
+                    else if(deltaPhi > M_PI) deltaPhi -= 2 * M_PI;
+                    const double newDeltaR = std::sqrt(deltaY * deltaY + deltaPhi * deltaPhi);
+                    if(newDeltaR < deltaR){
+                        deltaR = newDeltaR;
+                        jetIterator = newJet;
+                    }
+                }
+                const Jet jet = *jetIterator;
+                remainingLeadingJets.erase(jetIterator);
+
+                TIMING_RECORD("matched jet constituents", jet.particles().size());
+                PartonMatch match{flatIndex(parton), parton.pT(), parton.abspid(), deltaR, jet.pT(), {}, {}};
+                for(const Particle &particle: jet.particles()){
+                    match.constituents.push_back(flatIndex(particle));
+                    match.constituentPT.push_back(particle.pT());
+                }
+                snapshot->partons.push_back(std::move(match));
+            }
+            snapshot->partonInvariantMass = (excitedQuark.children()[0].momentum() + excitedQuark.children()[1].momentum()).mass();
+            snapshot->dijetInvariantMass = (jets[0].momentum() + jets[1].momentum()).mass();
+
+            //The three leading jets, and the further jets that count towards the jet multiplicity
+            for(std::size_t i = 0; i < 3 || (i < jets.size() && jets[i].pT() >= 100); i++){
+                const JetComposition &composition = jetComposition(jets[i], this->_darknessRecombiner);
+                TIMING_RECORD("jet constituents", composition.all.multiplicity);
+                snapshot->jets.push_back(JetSnapshot{jets[i].pT(), composition.pTInvisibility(), composition.pTDarkness(), {}});
+                if(this->_substructure && i < 3){
+                    snapshot->jets.back().substructure = this->_substructureCalculator.compute(jets[i].pseudojet(), composition);
+                }
+            }
+            this->submit(snapshot);
+
+            //Only plot the 10 events of each kind, but allow 20 events for decay modes that can be more interesting (W- or Z-bosons since they can decay further)
+            if(numberOfEventsWithDecay > (finalPartonLevelParticles.size() == 2 ? 10 : 20)){
+                return;
+            }
+            TIME_SCOPE("event display");
+            this->_telemetry.count("event displays");
+
+            //Draw the axes
+            this->_pTFlow.Draw("colz");
+            this->_pTFlow.Reset();
+            this->_pTFlow.SetStats(0);
+
+            //Plot the jets
+            std::vector<int> jetColors;
+            for(const Jet &jet: leadingJets){
+                jetColors.push_back(particleColor(jet, jets, finalPartonLevelParticles));
+            }
+            const auto jetPolygons = plotJets(leadingJets, this->_jetRadius, jetColors);
+
+            //Plot the stable particles
+            ParticleMarkers finalStateMarkers;
+            for(const Particle &finalParticle: finalState.particles()){
+                int marker = 20;
+                if(!finalParticle.isVisible()){
+                    if(finalParticle.isNeutrino()){
+                        marker = 24;
+                    }
+                    else{    //Dark matter
+                        marker = 25;
+                    }
+                }
+                finalStateMarkers.add(finalParticle, marker, particleColor(finalParticle, jets, finalPartonLevelParticles), false, 0.3);
+            }
+            const auto finalStatePolyMarkers = finalStateMarkers.draw();
+
+            //Plot the excited quark and its decay products
+            ParticleMarkers partonMarkers;
+            if(this->_plotSecondChildren != 2){
+                partonMarkers.add(excitedQuark, 29);
+            }
+            for(const Particle &particle: plottedPartonLevelParticles){
+                const bool isXPrimeBoson = this->_plotSecondChildren == 2 && std::find_if(finalPartonLevelParticles.begin(), finalPartonLevelParticles.end(), [&particle](const Particle &parton){
+                    return particle.isSame(parton);
+                }) == finalPartonLevelParticles.end();
+                partonMarkers.add(particle, isXPrimeBoson ? 29 : 20, this->_plotColor == PlotColor::PARTON ? particleColor(particle, jets, finalPartonLevelParticles) : EColor::kBlack);
+            }
+            const auto partonPolyMarkers = partonMarkers.draw();
+
+            //Print the page
+            this->_pTFlow.Draw("axis same");
+            drawTitle(&this->_pTFlow, this->title());
+            const std::vector<TString> &legends = this->_particleColorLegends.at(this->_plotColor);
+            const auto legend = drawLegend(&this->_pTFlow, (this->_plotColor == PlotColor::PARTON && this->_plotSecondChildren == 2) ? std::vector<int>{EColor::kOrange + 7, EColor::kAzure + 9} : this->_particleColors.at(this->_plotColor), (this->_plotColor == PlotColor::PARTON && this->_plotSecondChildren != 1) ? std::vector<TString>(legends.begin(), legends.end() - 1) : legends);
+            TIME_SCOPE("printing the event display");
+            this->printPage();
+        }
+
+        virtual void finalize() override{
+            this->applyFinishedResults(0);
+
+            //Plot the efficiency
+            TH1D efficiencyPlot(
+                "", ";#it{#Delta R};Efficiency between parton and particle level jet (%)",
+                this->_deltaRBins, 0.0, this->_deltaRMax    //x bins, min x, max x
+            );
+            for(int i = 0; i < this->_deltaRBins + 1; i++){
+                efficiencyPlot.AddBinContent(i, 50.0 * this->_efficiencyData[i] / this->numEvents());
+            }
+            this->plotHistogram(efficiencyPlot);
+
+            //Plot the pT and response
+            this->plotHistogram(this->_partonPTPlot);
+            for(const auto &pdgidPlotPair: this->_partonPTPlotByType){
+                this->plotHistogram(*pdgidPlotPair.second);
+            }
+            this->plotHistogram(this->_partonInvariantMassPlot);
+            this->plotHistogram(this->_jetResponsePlot);
+            this->plotHistogram(this->_fsResponsePlot);
+            this->plotHistogram(this->_fsInJetResponsePlot);
+            this->plotHistograms({&this->_leadingJetPTPlot, &this->_subLeadingJetPTPlot, &this->_thirdLeadingJetPTPlot}, std::vector<TString>{"Leading jet", "Subleading jet", "Third leading jet"});
+            this->plotHistogram(this->_dijetInvariantMassPlot);
+            if(this->_includeInvisibles){
+                this->plotHistograms({&this->_leadingJetInvisiblePlot, &this->_subLeadingJetInvisiblePlot, &this->_thirdLeadingJetInvisiblePlot}, std::vector<TString>{"Leading jet", "Subleading jet", "Third leading jet"});
+            }
+            this->plotHistograms({&this->_leadingJetDarknessPlot, &this->_subLeadingJetDarknessPlot, &this->_thirdLeadingJetDarknessPlot}, std::vector<TString>{"Leading jet", "Subleading jet", "Third leading jet"});
+
+            //Plot the jet multiplicity
+            const int maxMultiplicity = std::max_element(this->_jetMultiplicityData.begin(), this->_jetMultiplicityData.end(), [](const std::pair<int, int> &a, const std::pair<int, int> &b){return a.first < b.first;})->first;
+            TH1D darkJetMultiplicity80Plot(
+                "", ";Particle level jet multiplicity;Number of events",
+                maxMultiplicity * 2 + 2, 0.0, maxMultiplicity + 1    //x bins, min x, max x
+            ),
+            &darkJetMultiplicity50Plot = *static_cast<TH1D*>(darkJetMultiplicity80Plot.Clone()),
+            &darkJetMultiplicity20Plot = *static_cast<TH1D*>(darkJetMultiplicity80Plot.Clone()),
+            &jetMultiplicityPlot = *static_cast<TH1D*>(darkJetMultiplicity80Plot.Clone());
+            for(const auto &multiplicityEventsPair: this->_jetMultiplicityData){
+                jetMultiplicityPlot.Fill(multiplicityEventsPair.first - 0.1, multiplicityEventsPair.second);
+                jetMultiplicityPlot.Fill(multiplicityEventsPair.first + 0.1, multiplicityEventsPair.second);
+            }
+            for(const auto &multiplicityEventsPair: this->_darkJetMultiplicity20Data){
+                darkJetMultiplicity20Plot.Fill(multiplicityEventsPair.first - 0.1, multiplicityEventsPair.second);
+                darkJetMultiplicity20Plot.Fill(multiplicityEventsPair.first + 0.1, multiplicityEventsPair.second);
+            }
+            for(const auto &multiplicityEventsPair: this->_darkJetMultiplicity50Data){
+                darkJetMultiplicity50Plot.Fill(multiplicityEventsPair.first - 0.1, multiplicityEventsPair.second);
+                darkJetMultiplicity50Plot.Fill(multiplicityEventsPair.first + 0.1, multiplicityEventsPair.second);
+            }
+            for(const auto &multiplicityEventsPair: this->_darkJetMultiplicity80Data){
+                darkJetMultiplicity80Plot.Fill(multiplicityEventsPair.first - 0.1, multiplicityEventsPair.second);
+                darkJetMultiplicity80Plot.Fill(multiplicityEventsPair.first + 0.1, multiplicityEventsPair.second);
+            }
+            this->plotHistograms({&jetMultiplicityPlot, &darkJetMultiplicity20Plot, &darkJetMultiplicity50Plot, &darkJetMultiplicity80Plot}, std::vector<TString>{"All jets", "#it{f}_{dark} > 0.2", "#it{f}_{dark} > 0.5", "#it{f}_{dark} > 0.8"}, ", p_{T} cut = 100 GeV");
+
+            //Close the plot
+            this->_canvas.Print(this->_pagePdf + "]");
+            if(this->_checkpointInterval > 0){
+                this->concatenatePdfParts();
+            }
+
+            //Print the decay modes
+            for(PdgId parent: this->_resonancePdgId){
+                const auto decays = sortMap(this->_decays[parent]);
+                std::cout << std::endl << "Decay modes of " << particleName(parent) << ":" << std::endl << "----" << std::endl;
+                for(const std::pair<Decay, int> &decayCount: decays){
+                    std::cout << decayCount.first << ": " << (100.0 * decayCount.second / this->_numberOfParticles[parent]) << "%" << std::endl;
+                }
+            }
+
+            //Print the efficiency, purity and response
+            std::cout << std::endl;
+            const double efficiencyScale = this->_plotSecondChildren == 2 ? 25.0 : 50.0;
+            std::cout << "Purity: " << (100.0 * this->_purePT / this->_totalPT) << "%" << bootstrapUncertaintyText(this->_bootstrapPurity, 100.0, "%") << std::endl;
+            std::cout << "Efficiency at DeltaR = R: " << (efficiencyScale * this->_efficiencyData[this->efficiencyBin()] / this->numEvents()) << "%" << bootstrapUncertaintyText(this->_bootstrapEfficiency, efficiencyScale, "%") << std::endl;
+            std::cout << "Average response: " << (this->_responseSum / this->_numberOfEventsWithResponse) << bootstrapUncertaintyText(this->_bootstrapResponse) << std::endl;
+            std::cout << "JetResponse: " << quantileText(this->_jetResponseSketch, this->_percentiles) << std::endl;
+            std::cout << "FsResponse: " << quantileText(this->_fsResponseSketch, this->_percentiles) << std::endl;
+            std::cout << "FsInJetResponse: " << quantileText(this->_fsInJetResponseSketch, this->_percentiles) << std::endl;
+            const std::vector<std::string> jetNames{"LeadingJet", "SubLeadingJet", "ThirdLeadingJet"};
+            for(std::size_t i = 0; i < this->_jetDarknessSketches.size(); i++){
+                std::cout << jetNames[i] << "Darkness: " << quantileText(this->_jetDarknessSketches[i], this->_percentiles, 1.0, "%") << std::endl;
+            }
+            if(this->_substructure){
+                this->_substructureSummary.print(this->_percentiles);
+            }
+            if(this->_eventsWithTooFewJets > 0){
+                std::cout << "Skipped " << this->_eventsWithTooFewJets << " events with too few jets." << std::endl;
+            }
+            this->_preSelection.printCutflow(this->_cutflow);
+            if(this->_weightVariations && !this->_weightNames.empty()){
+                this->writeWeightVariations(efficiencyScale);
+            }
+            if(this->_checkpointInterval > 0 || this->_resume){
+                std::remove(this->_checkpointFile.c_str());    //The run is done, so a later run shouldn't resume from it
+            }
+            TIMING_WRITE_SUMMARY("PartonTruthEfficiency");
+            this->_telemetry.finish();
+        }
+
+    private:
+        //A parton and the jet it was matched to
+        struct PartonMatch{
+            int parton;    //Index in EventSnapshot::genealogy, like the other particle indices below
+            double partonPT;
+            PdgId partonAbsPdgId;
+            double deltaR, jetPT;
+            std::vector<int> constituents;
+            std::vector<double> constituentPT;
+        };
+
+        struct JetSnapshot{
+            double pT, invisibility, darkness;
+            JetSubstructure substructure;    //With SUBSTRUCTURE, for the three leading jets
+        };
+
+        //Everything analyzeSnapshot needs from an event, owned so that it outlives the Rivet event
+        struct EventSnapshot{
+            long number;    //_eventsSeen of the event, which seeds its bootstrap weights
+            std::vector<double> weights;    //With WEIGHT_VARIATIONS
+            FlatEventStorage genealogy;
+            std::vector<int> finalState;
+            std::vector<double> finalStatePT;
+            std::vector<PartonMatch> partons;
+            double partonInvariantMass, dijetInvariantMass;
+            std::vector<JetSnapshot> jets;
+
+            //Empties the vectors without giving back their memory. The genealogy is overwritten when it is filled.
+            void clear(){
+                this->weights.clear();
+                this->finalState.clear();
+                this->finalStatePT.clear();
+                this->partons.clear();
+                this->jets.clear();
+            }
+        };
+
+        //The results of the genealogy walks of an event
+        struct EventResult{
+            std::vector<std::vector<bool>> constituentIsFromParton;    //For each parton, whether each constituent of its jet comes from it
+            std::vector<double> fsPT, fsInJetPT;    //For each parton
+        };
+
+        //Index of the particle in the genealogy of the snapshot, -1 for particles that aren't in the HepMC event or were left out by compactGenealogy
+        int flatIndex(const Particle &particle) const{
+            if(particle.genParticle() == nullptr){
+                return -1;
+            }
+            const int index = particle.genParticle()->id() - 1;
+            return this->_compactGenealogy ? this->_compactedIndices[index] : index;
+        }
+
+        //The genealogy walks of an event, which only read the snapshot so that they can run on any thread. The sums are made in the same order as with Rivet particles, so the results are identical.
+        static EventResult analyzeSnapshot(const EventSnapshot &snapshot){
+            TIME_SCOPE("analyzing the snapshot");
+            const FlatEvent &event = snapshot.genealogy.view();
+            EventResult result;
+            for(const PartonMatch &match: snapshot.partons){
+                const FlatParticle parton = event.particle(match.parton);
+                std::vector<bool> fromParton;
+                for(const int constituent: match.constituents){
+                    fromParton.push_back(constituent >= 0 && particleIsFromParton(event.particle(constituent), parton));
+                }
+                result.constituentIsFromParton.push_back(std::move(fromParton));
+
+                std::vector<int> sortedConstituents = match.constituents;
+                std::sort(sortedConstituents.begin(), sortedConstituents.end());
+                double fsPT = 0.0, fsInJetPT = 0.0;
+                for(std::size_t i = 0; i < snapshot.finalState.size(); i++){
+                    const int particle = snapshot.finalState[i];
+                    if(particle >= 0 && particleIsFromParton(event.particle(particle), parton)){
+                        fsPT += snapshot.finalStatePT[i];
+                        if(std::binary_search(sortedConstituents.begin(), sortedConstituents.end(), particle)){
+                            fsInJetPT += snapshot.finalStatePT[i];
+                        }
+                    }
+                }
+                result.fsPT.push_back(fsPT);
+                result.fsInJetPT.push_back(fsInJetPT);
+            }
+            return result;
+        }
+
+        //Analyses the snapshot right away, or on the thread pool if PARALLEL_JOBS > 1
+        void submit(const std::shared_ptr<const EventSnapshot> &snapshot){
+            if(!this->_pool){
+                this->applyResult(*snapshot, analyzeSnapshot(*snapshot));
+                return;
+            }
+            this->_pending.emplace_back(snapshot, this->_pool->submit([snapshot]{
+                return analyzeSnapshot(*snapshot);
+            }));
+            this->applyFinishedResults(4 * this->_pool->threads());
+        }
+
+        //Applies the finished results in the order of the events, and waits for the oldest ones until at most maxPending events are left
+        void applyFinishedResults(std::size_t maxPending){
+            TIME_SCOPE("applying results");
+            while(!this->_pending.empty() && (this->_pending.size() > maxPending || this->_pending.front().second.wait_for(std::chrono::seconds(0)) == std::future_status::ready)){
+                this->applyResult(*this->_pending.front().first, this->_pending.front().second.get());
+                this->_pending.pop_front();
+            }
+        }
+
+        //Fills the histograms and counters of an event. Since this is always done in the order of the events, the output doesn't depend on PARALLEL_JOBS.
+        void applyResult(const EventSnapshot &snapshot, const EventResult &result){
+            double eventPurePT = 0.0, eventTotalPT = 0.0, eventResponseSum = 0.0;    //The numbers of this event alone, for the bootstrap
+            int efficientPartons = 0, eventResponses = 0;
+            for(std::size_t p = 0; p < snapshot.partons.size(); p++){
+                const PartonMatch &match = snapshot.partons[p];
+
+                //Efficiency
+                const int firstBin = match.deltaR * this->_deltaRBins / this->_deltaRMax;
+                for(int i = firstBin; i < this->_deltaRBins + 1; i++){
+                    this->_efficiencyData[i]++;
+                }
+                if(firstBin <= static_cast<int>(this->efficiencyBin())){
+                    efficientPartons++;
+                }
+
+                //Purity
+                for(std::size_t i = 0; i < match.constituents.size(); i++){
+                    if(result.constituentIsFromParton[p][i]){
+                        this->_purePT += match.constituentPT[i];
+                        eventPurePT += match.constituentPT[i];
+                    }
+                    this->_totalPT += match.constituentPT[i];
+                    eventTotalPT += match.constituentPT[i];
+                }
+
+                //Plot the pT of the partons
+                if(match.partonPT < this->_maxPT){
+                    this->fill(this->_partonPTPlot, match.partonPT, snapshot.weights);
+                    this->partonPTPlotByType(match.partonAbsPdgId).Fill(match.partonPT);
+                }
+                const double fsPT = result.fsPT[p], fsInJetPT = result.fsInJetPT[p];
+                if(match.deltaR <= this->_jetRadius){
+                    this->_jetResponseSketch.fill(match.jetPT / match.partonPT);
+                    if(fsInJetPT > 0){
+                        this->_fsInJetResponseSketch.fill(fsInJetPT / match.partonPT);
+                    }
+                    if(match.jetPT < match.partonPT * this->_maxResponse){
+                        this->fill(this->_jetResponsePlot, match.jetPT / match.partonPT, snapshot.weights);
+                        this->_responseSum += match.jetPT / match.partonPT;
+                        this->_numberOfEventsWithResponse++;
+                        eventResponseSum += match.jetPT / match.partonPT;
+                        eventResponses++;
+                    }
+                    if(fsInJetPT < match.partonPT * this->_maxResponse && fsInJetPT > 0){
+                        this->fill(this->_fsInJetResponsePlot, fsInJetPT / match.partonPT, snapshot.weights);
+                    }
+                }
+                if(fsPT > 0){
+                    this->_fsResponseSketch.fill(fsPT / match.partonPT);
+                }
+                if(fsPT < match.partonPT * this->_maxResponse && fsPT > 0){
+                    this->fill(this->_fsResponsePlot, fsPT / match.partonPT, snapshot.weights);
+                }
+            }
+
+            this->fillEventTotals(snapshot.number, snapshot.weights, eventPurePT, eventTotalPT, efficientPartons, eventResponseSum, eventResponses);
+
+            //Parton invariant mass
+            this->fill(this->_partonInvariantMassPlot, snapshot.partonInvariantMass, snapshot.weights);
+
+            //Jet pT and invariant mass
+            this->fill(this->_leadingJetPTPlot, snapshot.jets[0].pT, snapshot.weights);
+            this->fill(this->_subLeadingJetPTPlot, snapshot.jets[1].pT, snapshot.weights);
+            this->fill(this->_thirdLeadingJetPTPlot, snapshot.jets[2].pT, snapshot.weights);
+            this->fill(this->_dijetInvariantMassPlot, snapshot.dijetInvariantMass, snapshot.weights);
+
+            //Invisibility and darkness
+            this->fill(this->_leadingJetInvisiblePlot, snapshot.jets[0].invisibility * 100.0, snapshot.weights);
+            this->fill(this->_subLeadingJetInvisiblePlot, snapshot.jets[1].invisibility * 100.0, snapshot.weights);
+            this->fill(this->_thirdLeadingJetInvisiblePlot, snapshot.jets[2].invisibility * 100.0, snapshot.weights);
+            this->fill(this->_leadingJetDarknessPlot, snapshot.jets[0].darkness * 100.0, snapshot.weights);
+            this->fill(this->_subLeadingJetDarknessPlot, snapshot.jets[1].darkness * 100.0, snapshot.weights);
+            this->fill(this->_thirdLeadingJetDarknessPlot, snapshot.jets[2].darkness * 100.0, snapshot.weights);
+            for(std::size_t i = 0; i < this->_jetDarknessSketches.size(); i++){
+                this->_jetDarknessSketches[i].fill(snapshot.jets[i].darkness * 100.0);
+                if(this->_substructure){
+                    this->_substructureSummary.fill(snapshot.jets[i].substructure);
+                }
+            }
+
+            //Jet multiplicity
+            int jetMultiplicity = 0, darkJetMultiplicity20 = 0, darkJetMultiplicity50 = 0, darkJetMultiplicity80 = 0;
+            for(std::size_t i = 0; i < snapshot.jets.size(); i++){
+                if(snapshot.jets[i].pT < 100){
+                    break;
+                }
+                jetMultiplicity++;
+                const double darkness = snapshot.jets[i].darkness;
+                if(darkness > 0.2){
+                    darkJetMultiplicity20++;
+                }
+                if(darkness > 0.5){
+                    darkJetMultiplicity50++;
+                }
+                if(darkness > 0.8){
+                    darkJetMultiplicity80++;
+                }
+            }
+            this->_jetMultiplicityData[jetMultiplicity]++;
+            this->_darkJetMultiplicity20Data[darkJetMultiplicity20]++;
+            this->_darkJetMultiplicity50Data[darkJetMultiplicity50]++;
+            this->_darkJetMultiplicity80Data[darkJetMultiplicity80]++;
+        }
+
+        //Adds the purity, efficiency and response of one event to the bootstrap replicas, with weights that only depend on the number of the event, and with WEIGHT_VARIATIONS to the sums for each weight of the event
+        void fillEventTotals(long eventNumber, const std::vector<double> &weights, double purePT, double totalPT, int efficientPartons, double responseSum, int responses){
+            if(this->_bootstrapReplicas > 0){
+                TIME_SCOPE("bootstrap");
+                const BootstrapWeights bootstrapWeights(this->_bootstrapReplicas, eventNumber);
+                this->_bootstrapPurity.fill(bootstrapWeights, purePT, totalPT);
+                this->_bootstrapEfficiency.fill(bootstrapWeights, efficientPartons, 1.0);
+                this->_bootstrapResponse.fill(bootstrapWeights, responseSum, responses);
+            }
+            if(this->_weightVariations){
+                this->_weightedPurity.fill(weights, purePT, totalPT);
+                this->_weightedEfficiency.fill(weights, efficientPartons, 1.0);
+                this->_weightedResponse.fill(weights, responseSum, responses);
+            }
+        }
+
+        //Fills the histogram, and with WEIGHT_VARIATIONS the same bin of its copy with all weights of the event
+        void fill(TH1D &histogram, double value, const std::vector<double> &weights){
+            const int bin = histogram.Fill(value);
+            if(this->_weightVariations){
+                this->_weightedHistogramOf.at(&histogram)->fillBin(bin, weights);
+            }
+        }
+
+        //Makes the copies of the histograms and numbers for the weight variations
+        void setWeightNames(const std::vector<std::string> &names){
+            this->_weightNames = names;
+            this->_weightedPurity = WeightedRatio(names.size());
+            this->_weightedEfficiency = WeightedRatio(names.size());
+            this->_weightedResponse = WeightedRatio(names.size());
+            const std::vector<TH1D*> histograms = this->histograms();
+            const std::vector<std::string> histogramNames = this->histogramNames();
+            this->_weightedHistograms.clear();
+            for(std::size_t i = 0; i < histograms.size(); i++){
+                this->_weightedHistograms.push_back(WeightedHistogram(histogramNames[i], histograms[i]->GetNbinsX(), histograms[i]->GetXaxis()->GetXmin(), histograms[i]->GetXaxis()->GetXmax(), names.size()));
+            }
+            this->_weightedHistogramOf.clear();
+            for(std::size_t i = 0; i < histograms.size(); i++){
+                this->_weightedHistogramOf[histograms[i]] = &this->_weightedHistograms[i];
+            }
+        }
+
+        //Writes the histograms for all weights to WEIGHTS_FILE and prints the efficiency, purity and response for each weight
+        void writeWeightVariations(double efficiencyScale){
+            std::cout << std::endl << "Weight variations:" << std::endl;
+            for(std::size_t i = 0; i < this->_weightNames.size(); i++){
+                std::cout << this->_weightNames[i] << ": purity " << (100.0 * this->_weightedPurity.value(i)) << "%, efficiency at DeltaR = R " << (efficiencyScale * this->_weightedEfficiency.value(i)) << "%, average response " << this->_weightedResponse.value(i) << std::endl;
+            }
+            std::ofstream file(this->_weightsFile);
+            writeWeightedHistogramHeader(file, this->_weightNames);
+            for(const WeightedHistogram &histogram: this->_weightedHistograms){
+                histogram.write(file);
+            }
+            std::cout << "Histograms for all weights written to " << this->_weightsFile << std::endl;
+        }
+
+        //The bin of _efficiencyData at DeltaR = R
+        std::size_t efficiencyBin() const{
+            return this->_efficiencyData.size() * this->_jetRadius / this->_deltaRMax;
+        }
+
+        TH1D& partonPTPlotByType(PdgId absPdgId){
+            if(!this->_partonPTPlotByType.count(absPdgId)){
+                this->_partonPTPlotByType.insert({absPdgId, std::shared_ptr<TH1D>(new TH1D(
+                    "", (";#it{p_{T}}(#it{" + absParticleNameAsTLatex(absPdgId) + "}) (GeV);Number of events").c_str(),
+                    this->_bins, 0.0, this->_maxPT    //x bins, min x, max x
+                ))});
+            }
+            return *this->_partonPTPlotByType[absPdgId];
+        }
+
+        //The histograms that are filled for every event, in the order they are written to the checkpoint
+        std::vector<TH1D*> histograms(){
+            return {
+                &this->_partonPTPlot, &this->_partonInvariantMassPlot, &this->_jetResponsePlot, &this->_fsResponsePlot, &this->_fsInJetResponsePlot,
+                &this->_leadingJetPTPlot, &this->_subLeadingJetPTPlot, &this->_thirdLeadingJetPTPlot, &this->_dijetInvariantMassPlot,
+                &this->_leadingJetInvisiblePlot, &this->_subLeadingJetInvisiblePlot, &this->_thirdLeadingJetInvisiblePlot,
+                &this->_leadingJetDarknessPlot, &this->_subLeadingJetDarknessPlot, &this->_thirdLeadingJetDarknessPlot
+            };
+        }
+        //Names of the histograms above in WEIGHTS_FILE
+        static std::vector<std::string> histogramNames(){
+            return {
+                "PartonPT", "PartonInvariantMass", "JetResponse", "FsResponse", "FsInJetResponse",
+                "LeadingJetPT", "SubLeadingJetPT", "ThirdLeadingJetPT", "DijetInvariantMass",
+                "LeadingJetInvisibility", "SubLeadingJetInvisibility", "ThirdLeadingJetInvisibility",
+                "LeadingJetDarkness", "SubLeadingJetDarkness", "ThirdLeadingJetDarkness"
+            };
+        }
+        //The quantile sketches, in the order they are written to the checkpoint
+        std::vector<QuantileSketch*> quantileSketches(){
+            std::vector<QuantileSketch*> sketches{&this->_jetResponseSketch, &this->_fsResponseSketch, &this->_fsInJetResponseSketch};
+            for(QuantileSketch &sketch: this->_jetDarknessSketches){
+                sketches.push_back(&sketch);
+            }
+            for(QuantileSketch *sketch: this->_substructureSummary.sketches()){
+                sketches.push_back(sketch);
+            }
+            return sketches;
+        }
+
+        //Writes everything that has been counted so far, so that a run that is stopped can be continued with RESUME=1.
+        //The event displays since the last checkpoint are in their own part of the PDF, which is closed here so that it is complete even if the run is stopped later.
+        void writeCheckpoint(){
+            TIME_SCOPE("writing checkpoints");
+            this->applyFinishedResults(0);
+            if(this->_pagesInPart > 0){
+                this->_canvas.Print(this->_pagePdf + "]");
+                this->_pdfParts++;
+            }
+            CheckpointWriter writer(this->_checkpointFile, "PartonTruthEfficiency");
+
+            //The options that change what is counted, which must be the same when resuming
+            writer.write(this->_jetRadius);
+            writer.write(this->_includeInvisibles);
+            writer.write(this->_plotSecondChildren);
+            writer.write(this->_resonancePdgId);
+            writer.write(this->_bootstrapReplicas);
+            writer.write(this->_weightVariations);
+            writer.write(this->_clustering.minJetPT);
+            writer.write(this->_clustering.maxParticleEta);
+            writer.write(this->_clustering.maxJetEta);
+            writer.write(this->_clustering.maxJets);
+            writer.write(this->_preSelection.decayPdgIds);
+            writer.write(this->_preSelection.minPartonPT);
+            writer.write(this->_preSelection.minMultiplicity);
+            writer.write(this->_pileUp ? this->_pileUp->path() : std::string());
+            writer.write(this->_pileUp ? this->_pileUp->mu() : 0.0);
+            writer.write(this->_substructure);
+
+            writer.write<std::uint64_t>(this->_eventsSeen);
+            writer.write<std::int64_t>(this->_lastEventNumber);
+            writer.write<std::int64_t>(this->_eventsWithTooFewJets);
+            writer.write<std::int64_t>(this->_cutflow.events);
+            writer.write(this->_cutflow.passed);
+            writer.write(this->_cutflow.seconds);
+            writer.write(this->_pdfParts);
+            writer.write(this->_numberOfParticles);
+            writer.write<std::uint64_t>(this->_decays.size());
+            for(const auto &parentDecaysPair: this->_decays){
+                writer.write(parentDecaysPair.first);
+                writer.write<std::uint64_t>(parentDecaysPair.second.size());
+                for(const std::pair<const Decay, int> &decayCount: parentDecaysPair.second){
+                    writer.write(decayCount.first.parents());
+                    writer.write(decayCount.first.children());
+                    writer.write(decayCount.second);
+                }
+            }
+            writer.write(this->_efficiencyData);
+            writer.write(this->_totalPT);
+            writer.write(this->_purePT);
+            writer.write(this->_responseSum);
+            writer.write(this->_numberOfEventsWithResponse);
+            for(const BootstrapRatio *ratio: {&this->_bootstrapPurity, &this->_bootstrapEfficiency, &this->_bootstrapResponse}){
+                writer.write(ratio->numerators);
+                writer.write(ratio->denominators);
+            }
+            writer.write(this->_weightNames);
+            for(const WeightedRatio *ratio: {&this->_weightedPurity, &this->_weightedEfficiency, &this->_weightedResponse}){
+                writer.write(ratio->numerators);
+                writer.write(ratio->denominators);
+            }
+            for(const WeightedHistogram &histogram: this->_weightedHistograms){    //In the order of histograms()
+                writer.write(histogram.contents());
+            }
+            writer.write(this->_jetMultiplicityData);
+            writer.write(this->_darkJetMultiplicity20Data);
+            writer.write(this->_darkJetMultiplicity50Data);
+            writer.write(this->_darkJetMultiplicity80Data);
+            for(const QuantileSketch *sketch: this->quantileSketches()){
+                sketch->write(writer);
+            }
+            for(const TH1D *histogram: this->histograms()){
+                writeHistogram(writer, *histogram);
+            }
+            writer.write<std::uint64_t>(this->_partonPTPlotByType.size());
+            for(const auto &pdgidPlotPair: this->_partonPTPlotByType){
+                writer.write(pdgidPlotPair.first);
+                writeHistogram(writer, *pdgidPlotPair.second);
+            }
+            if(writer.close()){
+                std::cout << "Checkpoint after " << this->_eventsSeen << " events written to " << this->_checkpointFile << std::endl;
+            }
+
+            if(this->_pagesInPart > 0){
+                this->_pagePdf = this->pdfPart(this->_pdfParts);
+                this->_pagesInPart = 0;
+                this->_canvas.Print(this->_pagePdf + "[");
+            }
+            this->_lastCheckpoint = std::chrono::steady_clock::now();
+        }
+
+        //Restores everything from the checkpoint. Throws if it can't, since starting from the first event again would waste the time RESUME=1 is meant to save.
+        void readCheckpoint(){
+            CheckpointReader reader;
+            if(!reader.open(this->_checkpointFile, "PartonTruthEfficiency")){
+                throw std::runtime_error("Could not resume from the checkpoint " + this->_checkpointFile);
+            }
+            double jetRadius = 0.0;
+            bool includeInvisibles = false;
+            int plotSecondChildren = 0;
+            std::vector<PdgId> resonancePdgId;
+            int bootstrapReplicas = 0;
+            bool weightVariations = false;
+            double minJetPT = 0.0, maxParticleEta = 0.0, maxJetEta = 0.0;
+            int maxJets = 0;
+            std::vector<int> decayPdgIds;
+            double minPartonPT = 0.0;
+            int minMultiplicity = 0;
+            std::string pileUpFile;
+            double pileUpMu = 0.0;
+            bool substructure = false;
+            reader.read(jetRadius);
+            reader.read(includeInvisibles);
+            reader.read(plotSecondChildren);
+            reader.read(resonancePdgId);
+            reader.read(bootstrapReplicas);
+            reader.read(weightVariations);
+            reader.read(minJetPT);
+            reader.read(maxParticleEta);
+            reader.read(maxJetEta);
+            reader.read(maxJets);
+            reader.read(decayPdgIds);
+            reader.read(minPartonPT);
+            reader.read(minMultiplicity);
+            reader.read(pileUpFile);
+            reader.read(pileUpMu);
+            reader.read(substructure);
+            const bool sameClustering = minJetPT == this->_clustering.minJetPT && maxParticleEta == this->_clustering.maxParticleEta && maxJetEta == this->_clustering.maxJetEta && maxJets == this->_clustering.maxJets;
+            const bool samePreSelection = decayPdgIds == this->_preSelection.decayPdgIds && minPartonPT == this->_preSelection.minPartonPT && minMultiplicity == this->_preSelection.minMultiplicity;
+            const bool samePileUp = pileUpFile == (this->_pileUp ? this->_pileUp->path() : std::string()) && pileUpMu == (this->_pileUp ? this->_pileUp->mu() : 0.0);
+            if(reader.good() && (jetRadius != this->_jetRadius || includeInvisibles != this->_includeInvisibles || plotSecondChildren != this->_plotSecondChildren || resonancePdgId != this->_resonancePdgId || bootstrapReplicas != this->_bootstrapReplicas || weightVariations != this->_weightVariations || !sameClustering || !samePreSelection || !samePileUp || substructure != this->_substructure)){
+                throw std::runtime_error("The checkpoint " + this->_checkpointFile + " was written with different JET_RADIUS, INCLUDE_INVISIBLES, PLOT_SECOND_CHILDREN, RES_PDGID, BOOTSTRAP_REPLICAS, WEIGHT_VARIATIONS, MIN_JET_PT, MAX_PARTICLE_ETA, MAX_JET_ETA, MAX_JETS, PRESELECT_*, PILEUP_* or SUBSTRUCTURE options");
+            }
+
+            std::uint64_t eventsSeen = 0, numberOfParents = 0;
+            std::int64_t lastEventNumber = -1, eventsWithTooFewJets = 0, cutflowEvents = 0;
+            reader.read(eventsSeen);
+            reader.read(lastEventNumber);
+            reader.read(eventsWithTooFewJets);
+            reader.read(cutflowEvents);
+            reader.read(this->_cutflow.passed);
+            reader.read(this->_cutflow.seconds);
+            reader.read(this->_pdfParts);
+            reader.read(this->_numberOfParticles);
+            reader.read(numberOfParents);
+            for(std::uint64_t i = 0; i < numberOfParents && reader.good(); i++){
+                PdgId parent = 0;
+                std::uint64_t numberOfDecays = 0;
+                reader.read(parent);
+                reader.read(numberOfDecays);
+                for(std::uint64_t j = 0; j < numberOfDecays && reader.good(); j++){
+                    std::vector<PdgId> parents, children;
+                    int count = 0;
+                    reader.read(parents);
+                    reader.read(children);
+                    reader.read(count);
+                    this->_decays[parent][Decay(parents, children)] = count;
+                }
+            }
+            reader.read(this->_efficiencyData);
+            reader.read(this->_totalPT);
+            reader.read(this->_purePT);
+            reader.read(this->_responseSum);
+            reader.read(this->_numberOfEventsWithResponse);
+            for(BootstrapRatio *ratio: {&this->_bootstrapPurity, &this->_bootstrapEfficiency, &this->_bootstrapResponse}){
+                reader.read(ratio->numerators);
+                reader.read(ratio->denominators);
+            }
+            std::vector<std::string> weightNames;
+            reader.read(weightNames);
+            if(!weightNames.empty()){
+                this->setWeightNames(weightNames);
+            }
+            for(WeightedRatio *ratio: {&this->_weightedPurity, &this->_weightedEfficiency, &this->_weightedResponse}){
+                reader.read(ratio->numerators);
+                reader.read(ratio->denominators);
+            }
+            for(WeightedHistogram &histogram: this->_weightedHistograms){
+                reader.read(histogram.contents());
+            }
+            reader.read(this->_jetMultiplicityData);
+            reader.read(this->_darkJetMultiplicity20Data);
+            reader.read(this->_darkJetMultiplicity50Data);
+            reader.read(this->_darkJetMultiplicity80Data);
+            for(QuantileSketch *sketch: this->quantileSketches()){
+                sketch->read(reader);
+            }
+            for(TH1D *histogram: this->histograms()){
+                readHistogram(reader, *histogram);
+            }
+            std::uint64_t numberOfPartonTypes = 0;
+            reader.read(numberOfPartonTypes);
+            for(std::uint64_t i = 0; i < numberOfPartonTypes && reader.good(); i++){
+                PdgId absPdgId = 0;
+                reader.read(absPdgId);
+                readHistogram(reader, this->partonPTPlotByType(absPdgId));
+            }
+            if(!reader.good()){
+                throw std::runtime_error("The checkpoint " + this->_checkpointFile + " is incomplete");
+            }
+            this->_eventsToSkip = eventsSeen;
+            this->_lastEventNumber = lastEventNumber;
+            this->_eventsWithTooFewJets = eventsWithTooFewJets;
+            this->_cutflow.events = cutflowEvents;
+            std::cout << "Resuming after " << eventsSeen << " events from " << this->_checkpointFile << std::endl;
+        }
+
+        TString pdfPart(int part) const{
+            return TString::Format("%s.part%d.pdf", this->_pdf.Data(), part);
+        }
+
+        void printPage(){
+            this->_canvas.Print(this->_pagePdf);
+            this->_pagesInPart++;
+        }
+
+        //Joins the parts of the PDF that were written between the checkpoints into PDF_FILENAME
+        void concatenatePdfParts(){
+            std::vector<TString> parts;
+            for(int part = 0; part <= this->_pdfParts; part++){
+                parts.push_back(this->pdfPart(part));
+            }
+            if(concatenatePdfs(parts, this->_pdf)){
+                for(const TString &part: parts){
+                    std::remove(part.Data());
+                }
+            }
+            else{
+                std::cout << "Could not concatenate the parts of the PDF (this needs pdfunite or gs), the pages are in " << this->pdfPart(0) << " to " << this->pdfPart(this->_pdfParts) << std::endl;
+            }
+        }
+
+        TString title(const TString &extraLabel = "") const{
+            const TString model = modelName(this->_pdf);
+            TString process;
+            if(model.BeginsWith("EJ")){
+                process = "X' #bar{X}' #rightarrow q #bar{q}_{D} #bar{q} q_{D}";
+            }
+            else{
+                process = "Z' #rightarrow q_{D} #bar{q}_{D}";
+            }
+            return "Anti-#it{k_{t}}, #it{R} = " + std::regex_replace(std::to_string(this->_jetRadius), std::regex("([1-9]|\\.0)0+$"), "$1") + ", " + (this->_includeInvisibles ? "with" : "without") + " invisibles" + extraLabel + "\nModel " + model + ", " + process;
+        }
+
+        void plotHistogram(TH1D &histogram){
+            histogram.SetStats(0);
+            histogram.Draw("colz");
+            drawTitle(&histogram, this->title());
+            TIME_SCOPE("printing histograms");
+            this->printPage();
+        }
+
+        void plotHistograms(std::vector<TH1D*> histograms, const std::vector<TString> &legends, const TString &extraLabel = ""){
+            for(std::size_t i = 1; i < histograms.size() && i < this->_lineColors.size() + 1; i++){
+                histograms[i]->SetLineColor(this->_lineColors[i - 1]);
+            }
+            std::sort(histograms.begin(), histograms.end(), [](const TH1D *a, const TH1D *b){
+                return a->GetMaximum() > b->GetMaximum();
+            });
+            bool first = true;
+            for(TH1D *histogram: histograms){
+                histogram->SetStats(0);
+                histogram->Draw(first ? "hist" : "histsame");
+                first = false;
+            }
+            drawTitle(histograms[0], this->title(extraLabel));
+            const auto legend = drawLegend(histograms[0], this->_lineColors, legends);
+            TIME_SCOPE("printing histograms");
+            this->printPage();
+        }
+
+        int particleColor(const ParticleBase &particleOrJet, const Jets &jets, const Particles &finalPartonLevelParticles){
+            const Particle *particle = dynamic_cast<const Particle*>(&particleOrJet);
+            const Jet *jet = dynamic_cast<const Jet*>(&particleOrJet);
+            std::vector<int> colors = this->_particleColors.at(this->_plotColor);
+            switch(this->_plotColor){
+            case PlotColor::PARTON:
+                {
+                    const Particles sortedFinalPartonLevelParticles = particlesByEnergy(finalPartonLevelParticles);
+                    if(this->_plotSecondChildren == 2){
+                        if(sortedFinalPartonLevelParticles.size() >= 4){
+                            colors.erase(colors.begin() + 2);
+                            if(sortedFinalPartonLevelParticles[0].parents()[0].isSame(sortedFinalPartonLevelParticles[3].parents()[0]) && sortedFinalPartonLevelParticles[1].parents()[0].isSame(sortedFinalPartonLevelParticles[2].parents()[0])){
+                                std::iter_swap(colors.begin() + 2, colors.begin() + 3);
+                            }
+                            else if(sortedFinalPartonLevelParticles[0].parents()[0].isSame(sortedFinalPartonLevelParticles[1].parents()[0]) && sortedFinalPartonLevelParticles[2].parents()[0].isSame(sortedFinalPartonLevelParticles[3].parents()[0])){
+                                std::iter_swap(colors.begin() + 1, colors.begin() + 2);
+                            }
+                        }
+                    }
+                    for(Particle parentParticle: (jet ? particlesByEnergy(jet->particles()) : Particles{*particle})){
+                        while(parentParticle.parents().size() > 0){
+                            for(unsigned int i = 0; i < sortedFinalPartonLevelParticles.size() && i < colors.size(); i++){
+                                Particle parton = sortedFinalPartonLevelParticles[i];
+                                if(parentParticle.isSame(parton)){
+                                    return colors[i] + (jet ? (colors[i] == EColor::kOrange - 3 ? -1 : -9) : 0);
+                                }
+                            }
+                            parentParticle = particlesByEnergy(parentParticle.parents())[0];
+                        }
+                    }
+                    if(this->_plotSecondChildren == 2 && particle != nullptr){
+                        Particle currentParticle = *particle;
+                        while(currentParticle.children().size() == 1){
+                            currentParticle = currentParticle.children()[0];
+                        }
+                        if(sortedFinalPartonLevelParticles[0].parents()[0].isSame(currentParticle)){
+                            return EColor::kOrange + 7;
+                        }
+                        else for(const Particle &finalPartonLevelParticle: sortedFinalPartonLevelParticles){
+                            if(finalPartonLevelParticle.parents()[0].isSame(currentParticle)){
+                                return EColor::kAzure + 9;
+                            }
+                        }
+                    }
+                }
+                break;
+            case PlotColor::JET:
+                for(const std::pair<Jet, int> &jetColorPair: this->_plotSecondChildren == 2 ? std::vector<std::pair<Jet, int>>{{jets[0], colors[0]}, {jets[1], colors[1]}, {jets[2], colors[2]}, {jets[3], colors[3]}} : std::vector<std::pair<Jet, int>>{{jets[0], colors[0]}, {jets[1], colors[1]}}){
+                    if(jet != nullptr && jet->size() == jetColorPair.first.size() && jet->momentum() == jetColorPair.first.momentum()){
+                        return jetColorPair.second - 9;
+                    }
+                    else if(particle != nullptr && jetColorPair.first.containsParticle(*particle)){
+                        return jetColorPair.second;
+                    }
+                }
+                break;
+            case PlotColor::CHARGE:
+                if(particle != nullptr){
+                    return colors[1 - (particle->charge3() > 0) + (particle->charge3() < 0)];
+                }
+                break;
+            case PlotColor::TYPE:
+                //Jets
+                if(jet != nullptr){
+                    return colors[0];
+                }
+                //Partons
+                else if(particle->abspid() < 10 || particle->abspid() == 21){
+                    return colors[1];
+                }
+                //Bosons (excluding gluons)
+                else if(particle->abspid() / 10 == 2){
+                    return colors[2];
+                }
+                //Leptons
+                else if(particle->abspid() / 10 == 1){
+                    return colors[3];
+                }
+                //Mesons
+                else if(particle->abspid() >= 100 && particle->abspid() < 1000){
+                    return colors[4];
+                }
+                //Baryons or diquarks
+                else if(particle->abspid() >= 1000 && particle->abspid() < 10000){
+                    //Diquarks
+                    if(particle->abspid() % 100 < 10){
+                        return colors[5];
+                    }
+                    //Baryons
+                    else{
+                        return colors[6];
+                    }
+                }
+                //Unknown particles
+                break;
+            }
+            return jet ? EColor::kGray : EColor::kBlack;
+        }
+
+        int _numberOfPlots;
+        std::map<PdgId, int> _numberOfParticles;
+        std::map<PdgId, std::map<Decay, int>> _decays;
+
+        const double _jetRadius;
+        const bool _includeInvisibles;
+        const ClusteringOptions _clustering;
+        const TString _pdf;
+        const int _plotSecondChildren;
+        TCanvas _canvas;
+        TH2D _pTFlow;
+
+        static constexpr int _deltaRBins = 20;
+        static constexpr double _deltaRMax = 2.0;
+        std::vector<double> _efficiencyData;
+        double _totalPT, _purePT;
+        double _responseSum;
+        int _numberOfEventsWithResponse;
+        const int _bootstrapReplicas;
+        BootstrapRatio _bootstrapPurity, _bootstrapEfficiency, _bootstrapResponse;    //Replicas of the numbers above, with BOOTSTRAP_REPLICAS
+        const bool _weightVariations;
+        const std::string _weightsFile;
+        std::vector<std::string> _weightNames;    //Empty until the first event with WEIGHT_VARIATIONS
+        WeightedRatio _weightedPurity, _weightedEfficiency, _weightedResponse;
+        std::vector<WeightedHistogram> _weightedHistograms;    //With WEIGHT_VARIATIONS, a copy of histograms()[i] with all weights at index i
+        std::map<const TH1D*, WeightedHistogram*> _weightedHistogramOf;    //The copy in _weightedHistograms of each histogram, so that fill doesn't search histograms()
+        std::map<int, int> _jetMultiplicityData;    //Contains the number of jets with pT > 30GeV as key, and the number of events with that key as value
+        std::map<int, int> _darkJetMultiplicity20Data, _darkJetMultiplicity50Data, _darkJetMultiplicity80Data;    //Same as above but only counts jets with darkness > 20% / 50% / 80%
+        const std::vector<int> _percentiles;    //Printed for each quantile sketch after the median and the IQR
+        QuantileSketch _jetResponseSketch, _fsResponseSketch, _fsInJetResponseSketch;    //All responses, also the ones above _maxResponse that the plots leave out
+        std::vector<QuantileSketch> _jetDarknessSketches;    //Darkness of the three leading jets in %
+        DarknessRecombiner _darknessRecombiner;    //Has the clustered particles of the current event
+        const bool _substructure;
+        SubstructureCalculator _substructureCalculator;
+        SubstructureSummary _substructureSummary;    //Of the three leading jets, only filled with SUBSTRUCTURE
+
+        static constexpr int _bins = 50;
+        static constexpr double _maxPT = 3e3;
+        static constexpr double _maxResponse = 2.0;
+        TH1D _partonPTPlot, _partonInvariantMassPlot, _jetResponsePlot, _fsResponsePlot, _fsInJetResponsePlot;
+        std::map<PdgId, std::shared_ptr<TH1D>> _partonPTPlotByType;
+        TH1D _leadingJetPTPlot, _subLeadingJetPTPlot, _thirdLeadingJetPTPlot, _dijetInvariantMassPlot;
+        TH1D _leadingJetInvisiblePlot, _subLeadingJetInvisiblePlot, _thirdLeadingJetInvisiblePlot, _leadingJetDarknessPlot, _subLeadingJetDarknessPlot, _thirdLeadingJetDarknessPlot;
+
+        const std::vector<PdgId> _resonancePdgId;
+        const PreSelection _preSelection;
+        Cutflow _cutflow;
+        const std::shared_ptr<const PileUpPool> _pileUp;    //Null without pile-up
+        Telemetry _telemetry;
+
+        const int _parallelJobs;
+        std::unique_ptr<WorkStealingPool> _pool;    //Only used if PARALLEL_JOBS > 1
+        const std::shared_ptr<EventSnapshot> _reusedSnapshot = std::make_shared<EventSnapshot>();    //The snapshot of every event without the thread pool
+        std::deque<std::pair<std::shared_ptr<const EventSnapshot>, std::future<EventResult>>> _pending;    //In the order of the events
+        const bool _compactGenealogy;
+        FlatEventStorage _fullGenealogy;    //The event before compactGenealogy, reused between events
+        std::vector<int> _compactedIndices;    //Index in the compacted genealogy of each particle of the event, -1 if left out
+
+        const double _checkpointInterval;    //In seconds, 0 if checkpoints are off
+        const std::string _checkpointFile;
+        const bool _resume;
+        std::chrono::steady_clock::time_point _lastCheckpoint;
+        long _eventsSeen, _eventsToSkip;    //Including the events that were skipped when resuming
+        std::int64_t _lastEventNumber;
+        long _eventsWithTooFewJets;    //Events with fewer jets than the analysis uses after the clustering cuts, which are skipped
+        int _pdfParts;    //Number of finished parts of the PDF
+        int _pagesInPart;
+        TString _pagePdf;    //The file the pages are printed to, PDF_FILENAME or the current part if checkpoints are on
+
+        const std::vector<int> _lineColors{EColor::kOrange - 3, EColor::kGreen + 2, EColor::kMagenta + 2};
+        const std::map<PlotColor, std::vector<int>> _particleColors{
+            {PlotColor::PARTON, std::vector<int>{EColor::kRed, EColor::kBlue, EColor::kGreen + 2, EColor::kOrange - 3, EColor::kCyan + 2}},
+            {PlotColor::JET, std::vector<int>{EColor::kRed, EColor::kBlue, EColor::kGreen + 2, EColor::kMagenta + 2}},
+            {PlotColor::CHARGE, std::vector<int>{EColor::kRed, EColor::kBlue + 1, EColor::kGreen + 1}},
+            {PlotColor::TYPE, std::vector<int>{EColor::kBlue - 9, EColor::kMagenta + 2, EColor::kOrange, EColor::kGreen + 1, EColor::kRed, EColor::kPink + 7, EColor::kRed + 2}},
+            {PlotColor::NONE, std::vector<int>{}}
+        };
+        const std::map<PlotColor, std::vector<TString>> _particleColorLegends{
+            {PlotColor::PARTON, std::vector<TString>{"Leading parton & children", "Subleading parton & children", "Third leading parton & children"}},
+            {PlotColor::JET, std::vector<TString>{"Leading jet", "Subleading jet"}},
+            {PlotColor::CHARGE, std::vector<TString>{"Positive", "Neutral", "Negative"}},
+            {PlotColor::TYPE, std::vector<TString>{"Jet", "Parton", "Boson", "Lepton", "Meson", "Diquark", "Baryon"}},
+            {PlotColor::NONE, std::vector<TString>{}}
+        };
+        PlotColor _plotColor;
+    };
+
+    DECLARE_RIVET_PLUGIN(PartonTruthEfficiency);
 }
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <TROOT.h>
+#include <TFile.h>
+#include <TKey.h>
+#include <TClass.h>
+#include <TH1D.h>
+#include <TString.h>
+#include <iostream>
+#include <vector>
+#include <set>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+//Reads the TH1D histograms of a list of files, using the key list of each file as an index so that only the histograms whose names are accepted by select are deserialized.
+//The files are read concurrently by up to jobs threads. Each histogram is detached from its file and the files are closed after reading, so the caller owns the histograms.
+//The result has one entry per file (in the same order as files), each containing the (name, histogram) pairs in the order of the keys in the file. A file that can't be opened gives an empty entry.
+template<typename Select>
+std::vector<std::vector<std::pair<TString, TH1D*>>> readHistograms(const std::vector<TString> &files, const Select &select, int jobs = 1){
+    std::vector<std::vector<std::pair<TString, TH1D*>>> histograms(files.size());
+    jobs = std::max(1, std::min<int>(jobs, files.size()));
+    if(jobs > 1){
+        ROOT::EnableThreadSafety();
+    }
+
+    std::atomic<std::size_t> nextFile(0);
+    const auto readFiles = [&](){
+        for(std::size_t fileIndex = nextFile++; fileIndex < files.size(); fileIndex = nextFile++){
+            std::unique_ptr<TFile> file(TFile::Open(files[fileIndex], "READ"));
+            if(file == nullptr || file->IsZombie()){
+                std::cerr << "Could not open " << files[fileIndex] << "." << std::endl;
+                continue;
+            }
+            std::set<TString> readNames;    //The keys are sorted with the highest cycle first, only read that one
+            for(TObject *o: *file->GetListOfKeys()){
+                TKey *key = static_cast<TKey*>(o);
+                const TString name = key->GetName();
+                if(!select(name) || readNames.count(name)){
+                    continue;
+                }
+                const TClass *keyClass = TClass::GetClass(key->GetClassName());
+                if(keyClass == nullptr || !keyClass->InheritsFrom(TH1D::Class())){
+                    continue;
+                }
+                TH1D *histogram = static_cast<TH1D*>(key->ReadObj());
+                histogram->SetDirectory(nullptr);
+                histograms[fileIndex].push_back({name, histogram});
+                readNames.insert(name);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for(int job = 1; job < jobs; job++){
+        workers.emplace_back(readFiles);
+    }
+    readFiles();
+    for(std::thread &worker: workers){
+        worker.join();
+    }
+    return histograms;
+}
+
+//Whether a plot group with the given names is selected: always if selections is empty, otherwise if any of the names contains any of the selections
+inline bool groupIsSelected(const std::vector<TString> &groupNames, const std::vector<TString> &selections){
+    return selections.empty() || std::any_of(groupNames.begin(), groupNames.end(), [&selections](const TString &name){
+        return std::any_of(selections.begin(), selections.end(), [&name](const TString &selection){
+            return name.Contains(selection);
+        });
+    });
+}
+
+//Returns a function that accepts histogram names starting with prefix (except EventLoop_ histograms), and if selections isn't empty, only those that contain at least one of the selections.
+//Only use selections here if each histogram name is a plot group of its own, otherwise read with empty selections and filter the groups with groupIsSelected, so that a group is never only partly plotted.
+inline auto histogramSelection(const TString &prefix, const std::vector<TString> &selections = {}){
+    return [prefix, selections](const TString &name){
+        if(name.BeginsWith("EventLoop_") || !name.BeginsWith(prefix)){
+            return false;
+        }
+        return groupIsSelected({name}, selections);
+    };
+}
\ No newline at end of file
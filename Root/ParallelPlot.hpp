@@ -0,0 +1,109 @@
+#pragma once
+
+#include <TSystem.h>
+#include <TCanvas.h>
+#include <TString.h>
+#include <TError.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <thread>
+
+inline int defaultNumberOfJobs(){
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+//Concatenates single or multi-page PDF files in the given order, using pdfunite if it is available and ghostscript otherwise
+inline bool concatenatePdfs(const std::vector<TString> &pdfs, const TString &outfile){
+    TString files;
+    for(const TString &pdf: pdfs){
+        files += " '" + pdf + "'";
+    }
+    if(gSystem->Exec("command -v pdfunite > /dev/null 2>&1") == 0){
+        return gSystem->Exec("pdfunite" + files + " '" + outfile + "'") == 0;
+    }
+    if(gSystem->Exec("command -v gs > /dev/null 2>&1") == 0){
+        return gSystem->Exec("gs -q -dBATCH -dNOPAUSE -sDEVICE=pdfwrite -sOutputFile='" + outfile + "'" + files) == 0;
+    }
+    return false;
+}
+
+inline bool canConcatenatePdfs(){
+    return gSystem->Exec("command -v pdfunite > /dev/null 2>&1") == 0 || gSystem->Exec("command -v gs > /dev/null 2>&1") == 0;
+}
+
+//Splits the indices 0, ..., count - 1 into jobs contiguous chunks and calls work(first, last, job) for each chunk in a forked worker process. Returns false if any worker failed.
+template<typename Work>
+bool runInWorkerProcesses(std::size_t count, int jobs, const Work &work){
+    std::vector<pid_t> workers;
+    bool success = true;
+    for(int job = 0; job < jobs; job++){
+        const std::size_t first = count * job / jobs, last = count * (job + 1) / jobs;
+        const pid_t pid = fork();
+        if(pid == 0){
+            gErrorIgnoreLevel = kWarning;    //Don't let every worker print "Info in <TCanvas::Print>" for each page
+            work(first, last, job);
+            _exit(0);
+        }
+        else if(pid < 0){
+            std::cerr << "Could not start worker process " << job << "." << std::endl;
+            success = false;
+            break;
+        }
+        workers.push_back(pid);
+    }
+    for(pid_t worker: workers){
+        int status;
+        if(waitpid(worker, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0){
+            success = false;
+        }
+    }
+    if(!success){
+        std::cerr << "A plotting worker process failed." << std::endl;
+    }
+    return success;
+}
+
+//Renders each plot group as one or more pages of outfile. drawPage is called as drawPage(TCanvas &canvas, PlotGroup &plotGroup, const TString &pdf) and should draw the plot group on the canvas and print it to pdf.
+//With jobs > 1 the plot groups are split into contiguous chunks which are rendered by forked worker processes into separate PDFs, and the PDFs are then concatenated in order, so the output is the same as for jobs = 1.
+template<typename PlotGroup, typename DrawPage>
+bool plotInParallel(std::vector<PlotGroup> &plotGroups, const TString &outfile, int jobs, const DrawPage &drawPage){
+    jobs = std::min<int>(jobs, plotGroups.size());
+    if(jobs > 1 && !canConcatenatePdfs()){
+        std::cout << "Warning: neither pdfunite nor gs was found, plotting on one core." << std::endl;
+        jobs = 1;
+    }
+    if(jobs <= 1){
+        TCanvas canvas;
+        canvas.Print(outfile + "[");
+        for(PlotGroup &plotGroup: plotGroups){
+            drawPage(canvas, plotGroup, outfile);
+        }
+        canvas.Print(outfile + "]");
+        return true;
+    }
+
+    std::vector<TString> parts;
+    for(int job = 0; job < jobs; job++){
+        parts.push_back(TString::Format("%s.part%d.pdf", outfile.Data(), job));
+    }
+    bool success = runInWorkerProcesses(plotGroups.size(), jobs, [&](std::size_t first, std::size_t last, int job){
+        TCanvas canvas;
+        canvas.Print(parts[job] + "[");
+        for(std::size_t i = first; i < last; i++){
+            drawPage(canvas, plotGroups[i], parts[job]);
+        }
+        canvas.Print(parts[job] + "]");
+    });
+    if(success && !concatenatePdfs(parts, outfile)){
+        std::cerr << "Could not concatenate the pages into " << outfile << "." << std::endl;
+        success = false;
+    }
+    for(const TString &part: parts){
+        gSystem->Unlink(part);
+    }
+    return success;
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <TSystem.h>
+#include <TCanvas.h>
+#include <TString.h>
+#include <TH1D.h>
+#include <TAxis.h>
+#include <iostream>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <cstdint>
+#include <cctype>
+#include <filesystem>
+#include "ParallelPlot.hpp"
+#include "../Headers/ContentHash.hpp"
+
+//Part of the hash of every page. Increase this when a change to the drawing code changes how pages look, so that the cached pages are rendered again.
+static constexpr int plotCacheVersion = 1;
+
+//Adds everything about the histogram that affects how it is drawn to hash: binning, contents, errors, titles and line style
+inline ContentHash& addHistogram(ContentHash &hash, const TH1D *histogram){
+    hash.add(histogram->GetName()).add(histogram->GetTitle());
+    for(const TAxis *axis: {histogram->GetXaxis(), histogram->GetYaxis()}){
+        hash.add(axis->GetTitle()).add(axis->GetNbins()).add(axis->GetXmin()).add(axis->GetXmax());
+    }
+    const int bins = histogram->GetNbinsX() + 2;    //Including underflow and overflow
+    hash.add(histogram->GetArray(), bins * sizeof(double));
+    if(histogram->GetSumw2N() > 0){
+        hash.add(histogram->GetSumw2()->GetArray(), bins * sizeof(double));
+    }
+    return hash.add(histogram->GetLineColor()).add(histogram->GetLineStyle()).add(histogram->GetLineWidth());
+}
+
+//Whether the name of a file is that of a cached page, a 16 digit hex hash followed by .pdf
+inline bool isCachedPageName(const TString &name){
+    if(name.Length() != 20 || !name.EndsWith(".pdf")){
+        return false;
+    }
+    for(int i = 0; i < 16; i++){
+        if(!std::isxdigit(static_cast<unsigned char>(name[i])) || std::isupper(static_cast<unsigned char>(name[i]))){
+            return false;
+        }
+    }
+    return true;
+}
+
+//Whether path is directory or somewhere inside it, after resolving . and .. and symbolic links
+inline bool isInsideDirectory(const TString &path, const TString &directory){
+    std::filesystem::path parent = std::filesystem::weakly_canonical(std::filesystem::absolute(directory.Data()));
+    if(parent.filename().empty()){    //A trailing slash
+        parent = parent.parent_path();
+    }
+    const std::filesystem::path file = std::filesystem::weakly_canonical(std::filesystem::absolute(path.Data()));
+    return std::mismatch(parent.begin(), parent.end(), file.begin(), file.end()).first == parent.end();
+}
+
+//Same as plotInParallel, but each page is cached as a separate PDF in the Pages subdirectory of cacheDirectory, named after the hash of its inputs (hashPlotGroup(PlotGroup &plotGroup) should return a ContentHash of everything drawn on the page, including the title and legend texts, with addHistogram for the histograms).
+//Only the pages whose hash isn't in the cache are rendered, and outfile is then assembled from the cached pages. Each plot group must produce exactly one page. outfile can't be inside cacheDirectory.
+template<typename PlotGroup, typename HashPlotGroup, typename DrawPage>
+bool plotIncrementally(std::vector<PlotGroup> &plotGroups, const TString &outfile, int jobs, const TString &cacheDirectory, const HashPlotGroup &hashPlotGroup, const DrawPage &drawPage){
+    if(isInsideDirectory(outfile, cacheDirectory)){
+        std::cerr << "The output file " << outfile << " is inside the cache directory " << cacheDirectory << ", choose another cache directory." << std::endl;
+        return false;
+    }
+    if(!canConcatenatePdfs()){
+        std::cout << "Warning: neither pdfunite nor gs was found, rendering all pages." << std::endl;
+        return plotInParallel(plotGroups, outfile, jobs, drawPage);
+    }
+    const TString pageDirectory = cacheDirectory + "/Pages";
+    gSystem->mkdir(pageDirectory, true);
+
+    std::vector<TString> pages;
+    std::vector<std::size_t> changedPlotGroups;
+    for(std::size_t i = 0; i < plotGroups.size(); i++){
+        const TString page = pageDirectory + "/" + hashPlotGroup(plotGroups[i]).add(plotCacheVersion).hex().c_str() + ".pdf";
+        if(gSystem->AccessPathName(page) && std::find(pages.begin(), pages.end(), page) == pages.end()){    //Identical plot groups only need to be rendered once
+            changedPlotGroups.push_back(i);
+        }
+        pages.push_back(page);
+    }
+    std::cout << "Rendering " << changedPlotGroups.size() << " of " << plotGroups.size() << " pages, the rest are unchanged." << std::endl;
+
+    jobs = std::max(1, std::min<int>(jobs, changedPlotGroups.size()));
+    const bool success = changedPlotGroups.empty() || runInWorkerProcesses(changedPlotGroups.size(), jobs, [&](std::size_t first, std::size_t last, int){
+        TCanvas canvas;
+        for(std::size_t i = first; i < last; i++){
+            const std::size_t plotGroup = changedPlotGroups[i];
+            canvas.Print(pages[plotGroup] + "[");
+            drawPage(canvas, plotGroups[plotGroup], pages[plotGroup]);
+            canvas.Print(pages[plotGroup] + "]");
+        }
+    });
+    if(!success){
+        return false;
+    }
+    if(!concatenatePdfs(pages, outfile)){
+        std::cerr << "Could not concatenate the pages into " << outfile << "." << std::endl;
+        return false;
+    }
+
+    //Remove pages that are no longer used so that the cache doesn't grow forever, but nothing that isn't named like a page
+    const std::set<TString> usedPages(pages.begin(), pages.end());
+    void *directory = gSystem->OpenDirectory(pageDirectory);
+    for(const char *entry = gSystem->GetDirEntry(directory); entry != nullptr; entry = gSystem->GetDirEntry(directory)){
+        const TString page = pageDirectory + "/" + entry;
+        if(isCachedPageName(entry) && !usedPages.count(page)){
+            gSystem->Unlink(page);
+        }
+    }
+    gSystem->FreeDirectory(directory);
+    return true;
+}
\ No newline at end of file
@@ -1,115 +1,168 @@
-#include <TSystem.h>
-#include <TFile.h>
-#include <TH1D.h>
-#include <TCanvas.h>
-#include <TMarker.h>
-#include <iostream>
-#include "Legend.hpp"
-
-int main(int argc, char **argv){
-    TString infile, outfile;
-
-    for(int argi = 1; argi < argc; argi++){
-        TString arg = argv[argi];
-        if(arg.Contains(".root") || ((arg == "-i" || arg == "--input") && argi++)){
-            arg = argv[argi];
-            if(!gSystem->AccessPathName(arg.Data())){
-                infile = arg;
-            }
-            else{
-                std::cerr << "File " << argv[argi] << " does not exist." << std::endl;
-                return EXIT_FAILURE;
-            }
-        }
-        else if(arg == "-o" || arg == "--output"){
-            outfile = argv[++argi];
-        }
-        else if(arg == "-h" || arg == "--help"){
-            std::cout << "Usage: RecoTruthEfficiency [options] infile" << std::endl
-                << "Options:" << std::endl
-                << "  -h, --help:          Show this help text and exit" << std::endl
-                << "  -i, --input <path>:  Opens the specified root file as input file" << std::endl
-                << "  -o, --output <path>: Specifies which file the PDF output should be written to, defaults to the same as the input file except with .pdf instead of .root" << std::endl;
-            return 0;
-        }
-        else{
-            std::cerr << "Cannot interpret argument: " << argv[argi] << std::endl;
-            return EXIT_FAILURE;
-        }
-    }
-    if(infile == ""){
-        std::cerr << "No input file specified. Needs to be given as arugment." << std::endl;
-        return EXIT_FAILURE;
-    }
-    if(outfile == ""){
-        outfile = infile;
-        outfile.ReplaceAll(".root", ".pdf");
-    }
-
-    //Get the histograms
-    TFile *file = TFile::Open(infile);
-    std::vector<std::vector<TH1D*>> plotGroups;
-    const std::vector<int> colors = {EColor::kOrange - 3, EColor::kGreen + 2, EColor::kMagenta + 2};
-    for(TObject *o: *file->GetListOfKeys()){
-        const TString name = o->GetName();
-        if(name.BeginsWith("EventLoop_") || !name.BeginsWith("RecoTruthEfficiency_")){
-            continue;
-        }
-        TH1D *histogram = dynamic_cast<TH1D*>(file->Get(name));
-        if(histogram != nullptr){
-            histogram->SetStats(0);
-            const TString xTitle = histogram->GetXaxis()->GetTitle();
-            const TString yTitle = histogram->GetYaxis()->GetTitle();
-            if(plotGroups.size() == 0 || xTitle != plotGroups.back().back()->GetXaxis()->GetTitle() || yTitle != plotGroups.back().back()->GetYaxis()->GetTitle()){
-                plotGroups.push_back({histogram});
-            }
-            else{
-                const std::size_t colorIndex = plotGroups.back().size() - 1;
-                if(colorIndex < colors.size()){
-                    histogram->SetLineColor(colors[colorIndex]);
-                }
-                else if(colorIndex == colors.size()){
-                    std::cout << "Warning: more colors needed for plot " << histogram->GetXaxis()->GetTitle() << std::endl;
-                }
-                plotGroups.back().push_back(histogram);
-            }
-        }
-    }
-
-    //Plot the histograms
-    TCanvas canvas;
-    canvas.Print(outfile + "[");
-    for(std::vector<TH1D*> &plotGroup: plotGroups){
-        std::sort(plotGroup.begin(), plotGroup.end(), [](const TH1D *a, const TH1D *b){
-            return a->GetMaximum() > b->GetMaximum();
-        });
-        for(std::size_t i = 0; i < plotGroup.size(); i++){
-            TH1D *histogram = plotGroup[i];
-            if(i == 0){
-                histogram->Draw("hist");
-            }
-            else{
-                histogram->Draw("histsame");
-            }
-        }
-        const TString model = modelName(infile);
-        TString process;
-        if(model.BeginsWith("EJ")){
-            process = "X' #bar{X}' #rightarrow q #bar{q}_{D} #bar{q} q_{D}";
-        }
-        else{
-            process = "Z' #rightarrow q_{D} #bar{q}_{D}";
-        }
-        drawTitle(plotGroup[0], "Anti-#it{k_{t}}, #it{R} = " + TString(model.BeginsWith("EJ") ? "0.4" : "1.0") + ", with invisibles" + TString(plotGroup.size() > 3 ? ", p_{T} cut = 100 GeV" : "") + "\nModel " + model + ", " + process);
-        if(plotGroup.size() > 1){
-            const auto legend = drawLegend(plotGroup[0], colors, plotGroup.size() == 3 ? std::vector<TString>{"Leading jet", "Subleading jet", "Third leading jet"} : std::vector<TString>{"No darkness cut", "20% Darkness cut", "50% Darkness cut", "80% Darkness cut"});
-            canvas.Print(outfile);    //Repeat this both in if and else blocks so that the legend doesn't go out of scope
-        }
-        else{
-            canvas.Print(outfile);
-        }
-    }
-    canvas.Print(outfile + "]");
-
-    return 0;
+#include <TSystem.h>
+#include <TFile.h>
+#include <TH1D.h>
+#include <TCanvas.h>
+#include <TMarker.h>
+#include <iostream>
+#include "Legend.hpp"
+#include "ParallelPlot.hpp"
+#include "HistogramIngest.hpp"
+#include "PlotCache.hpp"
+
+int main(int argc, char **argv){
+    TString infile, outfile;
+    int jobs = defaultNumberOfJobs();
+    std::vector<TString> selections;
+    TString cacheDirectory;
+    bool incremental = false;
+
+    for(int argi = 1; argi < argc; argi++){
+        TString arg = argv[argi];
+        if(arg.Contains(".root") || ((arg == "-i" || arg == "--input") && argi++)){
+            arg = argv[argi];
+            if(!gSystem->AccessPathName(arg.Data())){
+                infile = arg;
+            }
+            else{
+                std::cerr << "File " << argv[argi] << " does not exist." << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if(arg == "-o" || arg == "--output"){
+            outfile = argv[++argi];
+        }
+        else if(arg == "-j" || arg == "--jobs"){
+            jobs = std::max(1, std::atoi(argv[++argi]));
+        }
+        else if(arg == "-s" || arg == "--select"){
+            selections.push_back(argv[++argi]);
+        }
+        else if(arg == "-c" || arg == "--incremental"){
+            incremental = true;
+        }
+        else if(arg == "--cache"){
+            cacheDirectory = argv[++argi];
+            incremental = true;
+        }
+        else if(arg == "-h" || arg == "--help"){
+            std::cout << "Usage: RecoTruthEfficiency [options] infile" << std::endl
+                << "Options:" << std::endl
+                << "  -h, --help:          Show this help text and exit" << std::endl
+                << "  -i, --input <path>:  Opens the specified root file as input file" << std::endl
+                << "  -o, --output <path>: Specifies which file the PDF output should be written to, defaults to the same as the input file except with .pdf instead of .root" << std::endl
+                << "  -j, --jobs <n>:      Number of processes to render the pages with, defaults to the number of cores" << std::endl
+                << "  -s, --select <text>: Only plot the pages with a histogram whose name contains <text>, can be given several times" << std::endl
+                << "  -c, --incremental:   Keep each page in a cache and only render the pages whose histograms, titles or styling changed since the last run" << std::endl
+                << "  --cache <path>:      Same as --incremental, but with the given cache directory instead of <output>.cache" << std::endl;
+            return 0;
+        }
+        else{
+            std::cerr << "Cannot interpret argument: " << argv[argi] << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if(infile == ""){
+        std::cerr << "No input file specified. Needs to be given as arugment." << std::endl;
+        return EXIT_FAILURE;
+    }
+    if(outfile == ""){
+        outfile = infile;
+        outfile.ReplaceAll(".root", ".pdf");
+    }
+
+    //Get the histograms
+    std::vector<std::vector<TH1D*>> plotGroups;
+    const std::vector<int> colors = {EColor::kOrange - 3, EColor::kGreen + 2, EColor::kMagenta + 2};
+    std::vector<std::vector<TString>> groupNames;    //The histogram names of each plot group, for the selections
+    for(const auto &nameHistogramPair: readHistograms({infile}, histogramSelection("RecoTruthEfficiency_"))[0]){
+        TH1D *histogram = nameHistogramPair.second;
+        histogram->SetStats(0);
+        const TString xTitle = histogram->GetXaxis()->GetTitle();
+        const TString yTitle = histogram->GetYaxis()->GetTitle();
+        if(plotGroups.size() == 0 || xTitle != plotGroups.back().back()->GetXaxis()->GetTitle() || yTitle != plotGroups.back().back()->GetYaxis()->GetTitle()){
+            plotGroups.push_back({histogram});
+            groupNames.push_back({});
+        }
+        else{
+            const std::size_t colorIndex = plotGroups.back().size() - 1;
+            if(colorIndex < colors.size()){
+                histogram->SetLineColor(colors[colorIndex]);
+            }
+            else if(colorIndex == colors.size()){
+                std::cout << "Warning: more colors needed for plot " << histogram->GetXaxis()->GetTitle() << std::endl;
+            }
+            plotGroups.back().push_back(histogram);
+        }
+        groupNames.back().push_back(nameHistogramPair.first);
+    }
+    //The plot groups are only known from the axis titles after reading, so the selections are applied to whole groups here
+    std::vector<std::vector<TH1D*>> selectedPlotGroups;
+    for(std::size_t i = 0; i < plotGroups.size(); i++){
+        if(groupIsSelected(groupNames[i], selections)){
+            selectedPlotGroups.push_back(plotGroups[i]);
+        }
+        else{
+            for(TH1D *histogram: plotGroups[i]){
+                delete histogram;
+            }
+        }
+    }
+    plotGroups = selectedPlotGroups;
+
+    //Plot the histograms
+    const TString model = modelName(infile);
+    //The title and legend texts of a page, which are also part of the page hashes
+    const auto pageTexts = [&model](const std::vector<TH1D*> &plotGroup){
+        TString process;
+        if(model.BeginsWith("EJ")){
+            process = "X' #bar{X}' #rightarrow q #bar{q}_{D} #bar{q} q_{D}";
+        }
+        else{
+            process = "Z' #rightarrow q_{D} #bar{q}_{D}";
+        }
+        const TString title = "Anti-#it{k_{t}}, #it{R} = " + TString(model.BeginsWith("EJ") ? "0.4" : "1.0") + ", with invisibles" + TString(plotGroup.size() > 3 ? ", p_{T} cut = 100 GeV" : "") + "\nModel " + model + ", " + process;
+        const std::vector<TString> legends = plotGroup.size() == 1 ? std::vector<TString>{} : plotGroup.size() == 3 ? std::vector<TString>{"Leading jet", "Subleading jet", "Third leading jet"} : std::vector<TString>{"No darkness cut", "20% Darkness cut", "50% Darkness cut", "80% Darkness cut"};
+        return std::make_pair(title, legends);
+    };
+    const auto drawPage = [&colors, &pageTexts](TCanvas &canvas, std::vector<TH1D*> &plotGroup, const TString &pdf){
+        std::sort(plotGroup.begin(), plotGroup.end(), [](const TH1D *a, const TH1D *b){
+            return a->GetMaximum() > b->GetMaximum();
+        });
+        for(std::size_t i = 0; i < plotGroup.size(); i++){
+            TH1D *histogram = plotGroup[i];
+            if(i == 0){
+                histogram->Draw("hist");
+            }
+            else{
+                histogram->Draw("histsame");
+            }
+        }
+        const auto texts = pageTexts(plotGroup);
+        drawTitle(plotGroup[0], texts.first);
+        if(plotGroup.size() > 1){
+            const auto legend = drawLegend(plotGroup[0], colors, texts.second);
+            canvas.Print(pdf);    //Repeat this both in if and else blocks so that the legend doesn't go out of scope
+        }
+        else{
+            canvas.Print(pdf);
+        }
+    };
+    const auto hashPlotGroup = [&pageTexts](const std::vector<TH1D*> &plotGroup){
+        const auto texts = pageTexts(plotGroup);
+        ContentHash hash;
+        hash.add(texts.first).add(texts.second);
+        for(const TH1D *histogram: plotGroup){
+            addHistogram(hash, histogram);
+        }
+        return hash;
+    };
+    if(incremental && cacheDirectory == ""){
+        cacheDirectory = outfile + ".cache";
+    }
+    const bool success = incremental ? plotIncrementally(plotGroups, outfile, jobs, cacheDirectory, hashPlotGroup, drawPage) : plotInParallel(plotGroups, outfile, jobs, drawPage);
+    if(!success){
+        return EXIT_FAILURE;
+    }
+
+    return 0;
 }
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <utility>
+
+//Queue between threads with a maximum size, so that a fast producer (for example the thread reading the input file) waits for the consumers instead of filling up the memory
+template<typename T> class BoundedQueue{
+public:
+    explicit BoundedQueue(std::size_t capacity): _capacity(capacity), _closed(false){}
+
+    //Waits until there is space in the queue. Returns false without adding item if the queue has been closed.
+    bool push(T item){
+        std::unique_lock<std::mutex> lock(this->_mutex);
+        this->_notFull.wait(lock, [this]{
+            return this->_items.size() < this->_capacity || this->_closed;
+        });
+        if(this->_closed){
+            return false;
+        }
+        this->_items.push_back(std::move(item));
+        this->_notEmpty.notify_one();
+        return true;
+    }
+
+    //Waits until there is an item in the queue. Returns false when the queue is closed and empty, which means that there will be no more items.
+    bool pop(T &item){
+        std::unique_lock<std::mutex> lock(this->_mutex);
+        this->_notEmpty.wait(lock, [this]{
+            return !this->_items.empty() || this->_closed;
+        });
+        if(this->_items.empty()){
+            return false;
+        }
+        item = std::move(this->_items.front());
+        this->_items.pop_front();
+        this->_notFull.notify_one();
+        return true;
+    }
+
+    //No more items can be pushed after this, but the items already in the queue can still be popped
+    void close(){
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        this->_closed = true;
+        this->_notEmpty.notify_all();
+        this->_notFull.notify_all();
+    }
+
+private:
+    const std::size_t _capacity;
+    bool _closed;
+    std::deque<T> _items;
+    std::mutex _mutex;
+    std::condition_variable _notEmpty, _notFull;
+};
\ No newline at end of file
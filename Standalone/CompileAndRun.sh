@@ -0,0 +1,10 @@
+args=("$@")
+if [[ "$TIMING" == 1 ]]
+then
+    timingFlags=-DDARKJET_TIMING    #Compiles in the timers of Headers/Timing.hpp
+fi
+if [[ "${args[0]}" == PythiaPipeline ]]
+then
+    pythiaFlags=$(pythia8-config --cxxflags --libs)    #Only PythiaPipeline needs Pythia, so the other programs can be built without it
+fi
+g++ -o "${args[0]}" "${args[0]}.cpp" -std=c++17 -O2 -pthread $timingFlags $(fastjet-config --cxxflags --libs) $(HepMC3-config --cflags --libs) $pythiaFlags -ldl -Wno-unused-function && ./"${args[0]}" "${args[@]:1}"    #-Wno-unused-function to be able to reuse headers
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include <HepMC3/GenEvent.h>
+#include <HepMC3/ReaderFactory.h>
+#include <iostream>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <cstdlib>
+#include "../Headers/ParticleHandle.hpp"
+#include "../Headers/EventCache.hpp"
+
+//Converts a HepMC file once to an event cache, which DarkJetPipeline can read many times without parsing HepMC again
+int main(int argc, char **argv){
+    std::string infile, outfile;
+    long maxEvents = -1;
+
+    for(int argi = 1; argi < argc; argi++){
+        const std::string arg = argv[argi];
+        if(arg == "-n" || arg == "--events"){
+            maxEvents = std::atol(argv[++argi]);
+        }
+        else if(arg == "-h" || arg == "--help"){
+            std::cout << "Usage: ConvertToEventCache [options] infile outfile" << std::endl
+                << "Options:" << std::endl
+                << "  -h, --help:       Show this help text and exit" << std::endl
+                << "  -n, --events <n>: Only convert the first <n> events" << std::endl;
+            return 0;
+        }
+        else if(infile == ""){
+            infile = arg;
+        }
+        else if(outfile == ""){
+            outfile = arg;
+        }
+        else{
+            std::cerr << "Cannot interpret argument: " << argv[argi] << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if(infile == "" || outfile == ""){
+        std::cerr << "The input and output files need to be given as arguments." << std::endl;
+        return EXIT_FAILURE;
+    }
+    const std::shared_ptr<HepMC3::Reader> reader = HepMC3::deduce_reader(infile);
+    if(!reader || reader->failed()){
+        std::cerr << "Could not read " << infile << "." << std::endl;
+        return EXIT_FAILURE;
+    }
+    EventCacheWriter writer;
+    if(!writer.open(outfile)){
+        return EXIT_FAILURE;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    HepMC3::GenEvent event;
+    FlatEventStorage flatEvent;
+    long number = 0;
+    for(; maxEvents < 0 || number < maxEvents; number++){
+        reader->read_event(event);
+        if(reader->failed()){
+            break;
+        }
+        event.set_units(HepMC3::Units::GEV, HepMC3::Units::MM);    //The cache is always in GeV and mm
+        flatEvent.fill(event);
+        if(!writer.write(flatEvent.view(), event.event_number())){
+            return EXIT_FAILURE;
+        }
+    }
+    if(!writer.close()){
+        std::cerr << "Could not write " << outfile << "." << std::endl;
+        return EXIT_FAILURE;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Converted " << number << " events in " << seconds << " s." << std::endl;
+    return 0;
+}
\ No newline at end of file
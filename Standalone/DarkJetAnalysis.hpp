@@ -0,0 +1,645 @@
+#pragma once
+
+#include <fastjet/ClusterSequence.hh>
+#include <fastjet/PseudoJet.hh>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <algorithm>
+#include <utility>
+#include <memory>
+#include <cstdint>
+#include "../Headers/ParticleHandle.hpp"
+#include "../Headers/Darkness.hpp"
+#include "../Headers/CompactGenealogy.hpp"
+#include "../Headers/Bootstrap.hpp"
+#include "../Headers/MultiWeight.hpp"
+#include "../Headers/JetClustering.hpp"
+#include "../Headers/QuantileSketch.hpp"
+#include "../Headers/PreSelection.hpp"
+#include "../Headers/PileUp.hpp"
+#include "../Headers/Substructure.hpp"
+#include "../Headers/ParticleSort.hpp"
+#include "../Headers/GetEnvVars.hpp"
+#include "../Headers/Timing.hpp"
+
+//Same options and defaults as the PartonTruthEfficiency Rivet analysis
+struct DarkJetOptions{
+    DarkJetOptions():
+        jetRadius(getDoubleFromEnvVar("JET_RADIUS", 1.0)),
+        includeInvisibles(getIntFromEnvVar("INCLUDE_INVISIBLES", 1)),
+        plotSecondChildren(getIntFromEnvVar("PLOT_SECOND_CHILDREN", 0)),
+        resonancePdgIds(getIntVectorFromEnvVar("RES_PDGID", std::vector<int>{4900001, 4900023})),
+        compactGenealogy(getIntFromEnvVar("COMPACT_GENEALOGY", 1)),
+        bootstrapReplicas(getIntFromEnvVar("BOOTSTRAP_REPLICAS", 0)),
+        weightVariations(getIntFromEnvVar("WEIGHT_VARIATIONS", 0)),
+        percentiles(getIntVectorFromEnvVar("PERCENTILES", std::vector<int>{10, 90})),
+        substructure(getIntFromEnvVar("SUBSTRUCTURE", 0)),
+        preSelection(this->resonancePdgIds, this->plotSecondChildren),
+        pileUp(pileUpPoolFromEnvVars())
+    {}
+
+    double jetRadius;
+    bool includeInvisibles;
+    int plotSecondChildren;
+    std::vector<int> resonancePdgIds;
+    bool compactGenealogy;
+    int bootstrapReplicas;
+    bool weightVariations;
+    std::vector<int> percentiles;
+    bool substructure;
+    ClusteringOptions clustering;
+    PreSelection preSelection;
+    std::shared_ptr<const PileUpPool> pileUp;    //Null without pile-up
+    static constexpr std::size_t leadingJets = 3;    //Whose pT, invisibility, darkness and substructure are plotted
+    static constexpr int deltaRBins = 20;
+    static constexpr double deltaRMax = 2.0;
+    static constexpr int bins = 50;
+    static constexpr double maxPT = 3e3;
+    static constexpr double maxResponse = 2.0;
+};
+
+//Histogram with fixed bins, underflow and overflow like a TH1D, which can be merged exactly
+class Histogram{
+public:
+    Histogram(const std::string &name = "", int bins = 1, double min = 0.0, double max = 1.0): _name(name), _min(min), _max(max), _contents(bins + 2, 0.0), _sum(0.0), _entries(0){}
+
+    void fill(double value, double weight = 1.0){
+        const int bins = this->_contents.size() - 2;
+        int bin;
+        if(value < this->_min){
+            bin = 0;
+        }
+        else if(value >= this->_max){
+            bin = bins + 1;
+        }
+        else{
+            bin = 1 + std::min<int>((value - this->_min) / (this->_max - this->_min) * bins, bins - 1);
+            this->_sum += weight * value;
+            this->_entries += weight;
+        }
+        this->_contents[bin] += weight;
+    }
+
+    void merge(const Histogram &other){
+        for(std::size_t i = 0; i < this->_contents.size(); i++){
+            this->_contents[i] += other._contents[i];
+        }
+        this->_sum += other._sum;
+        this->_entries += other._entries;
+    }
+
+    //Mean of the values that were filled inside the range
+    double mean() const{
+        return this->_entries > 0 ? this->_sum / this->_entries : 0.0;
+    }
+
+    //Writes one line per bin (including underflow and overflow) with the name, lower edge, upper edge and contents
+    void write(std::ostream &stream) const{
+        const int bins = this->_contents.size() - 2;
+        for(int i = 0; i < bins + 2; i++){
+            const double low = i == 0 ? -INFINITY : this->_min + (this->_max - this->_min) * (i - 1) / bins;
+            const double high = i == bins + 1 ? INFINITY : this->_min + (this->_max - this->_min) * i / bins;
+            stream << this->_name << "\t" << low << "\t" << high << "\t" << this->_contents[i] << std::endl;
+        }
+    }
+
+    const std::string& name() const{
+        return this->_name;
+    }
+    int bins() const{
+        return this->_contents.size() - 2;
+    }
+    double min() const{
+        return this->_min;
+    }
+    double max() const{
+        return this->_max;
+    }
+    //bins + 2 entries, including underflow and overflow
+    const std::vector<double>& contents() const{
+        return this->_contents;
+    }
+
+private:
+    std::string _name;
+    double _min, _max;
+    std::vector<double> _contents;
+    double _sum, _entries;
+};
+
+//What analyzeDarkJetEvent finds in a single event: its counts and the values for the histograms and sketches, which DarkJetAccumulator::addEvent adds to the totals.
+//clear keeps the arrays, so a thread that reuses one object for all its events doesn't allocate once they have grown to the largest event.
+struct DarkJetEventResult{
+    DarkJetEventResult(): efficiencyData(DarkJetOptions::deltaRBins + 1, 0){
+        this->clear();
+    }
+
+    void clear(){
+        this->withoutResonance = false;
+        this->withTooFewJets = false;
+        this->cutflow.events = 0;
+        std::fill(this->cutflow.passed.begin(), this->cutflow.passed.end(), 0);
+        std::fill(this->cutflow.seconds.begin(), this->cutflow.seconds.end(), 0.0);
+        std::fill(this->efficiencyData.begin(), this->efficiencyData.end(), 0);
+        this->totalPT = 0.0;
+        this->purePT = 0.0;
+        this->responseSum = 0.0;
+        this->numberOfResponses = 0;
+        for(std::vector<double> *values: {&this->partonPT, &this->jetResponse, &this->fsResponse, &this->fsInJetResponse, &this->jetPT, &this->jetInvisibility, &this->jetDarkness, &this->allJetResponses, &this->allFsResponses, &this->allFsInJetResponses}){
+            values->clear();
+        }
+        this->substructures.clear();
+        this->jetMultiplicities.clear();
+    }
+
+    bool withoutResonance, withTooFewJets;
+    Cutflow cutflow;
+    std::vector<long> efficiencyData;
+    double totalPT, purePT;
+    double responseSum;
+    long numberOfResponses;
+    std::vector<double> partonPT, jetResponse, fsResponse, fsInJetResponse;    //The values for the histograms of the same name in DarkJetAccumulator
+    std::vector<double> jetPT, jetInvisibility, jetDarkness;    //One value for each of the leading jets
+    std::vector<double> allJetResponses, allFsResponses, allFsInJetResponses;    //For the sketches, also the ones above maxResponse
+    std::vector<JetSubstructure> substructures;    //Only filled with SUBSTRUCTURE
+    std::vector<int> jetMultiplicities;    //Empty if the event was rejected, otherwise one for each entry of DarkJetAccumulator::jetMultiplicityData
+};
+
+//Everything PartonTruthEfficiency accumulates for its headline numbers. The events are added with addEvent in event order, so the result doesn't depend on the number of threads, and accumulators of separate runs can be merged.
+class DarkJetAccumulator{
+public:
+    DarkJetAccumulator():
+        events(0),
+        eventsWithoutResonance(0),
+        eventsWithTooFewJets(0),
+        efficiencyData(DarkJetOptions::deltaRBins + 1, 0),
+        totalPT(0.0),
+        purePT(0.0),
+        responseSum(0.0),
+        numberOfEventsWithResponse(0),
+        partonPT("PartonPT", DarkJetOptions::bins, 0.0, DarkJetOptions::maxPT / 2),
+        jetResponse("JetResponse", DarkJetOptions::bins, 0.0, DarkJetOptions::maxResponse),
+        fsResponse("FsResponse", DarkJetOptions::bins, 0.0, DarkJetOptions::maxResponse * 3 / 2),
+        fsInJetResponse("FsInJetResponse", DarkJetOptions::bins, 0.0, DarkJetOptions::maxResponse),
+        jetDarknessSketches(3)
+    {
+        const std::vector<std::string> jetNames{"LeadingJet", "SubLeadingJet", "ThirdLeadingJet"};
+        for(const std::string &jetName: jetNames){
+            this->jetPT.push_back(Histogram(jetName + "PT", DarkJetOptions::bins, 0.0, DarkJetOptions::maxPT / 2));
+            this->jetInvisibility.push_back(Histogram(jetName + "Invisibility", DarkJetOptions::bins, 0.0, 100.0));
+            this->jetDarkness.push_back(Histogram(jetName + "Darkness", DarkJetOptions::bins, 0.0, 100.0));
+        }
+    }
+
+    void merge(const DarkJetAccumulator &other){
+        this->events += other.events;
+        this->eventsWithoutResonance += other.eventsWithoutResonance;
+        this->eventsWithTooFewJets += other.eventsWithTooFewJets;
+        this->cutflow.merge(other.cutflow);
+        for(std::size_t i = 0; i < this->efficiencyData.size(); i++){
+            this->efficiencyData[i] += other.efficiencyData[i];
+        }
+        this->totalPT += other.totalPT;
+        this->purePT += other.purePT;
+        this->responseSum += other.responseSum;
+        this->numberOfEventsWithResponse += other.numberOfEventsWithResponse;
+        this->bootstrapPurity.merge(other.bootstrapPurity);
+        this->bootstrapEfficiency.merge(other.bootstrapEfficiency);
+        this->bootstrapResponse.merge(other.bootstrapResponse);
+        this->weightedPurity.merge(other.weightedPurity);
+        this->weightedEfficiency.merge(other.weightedEfficiency);
+        this->weightedResponse.merge(other.weightedResponse);
+        if(this->weightedHistograms.empty()){
+            this->weightedHistograms = other.weightedHistograms;
+        }
+        else{
+            for(std::size_t i = 0; i < this->weightedHistograms.size() && i < other.weightedHistograms.size(); i++){
+                this->weightedHistograms[i].merge(other.weightedHistograms[i]);
+            }
+        }
+        const std::vector<Histogram*> histograms = allHistograms(*this);
+        const std::vector<const Histogram*> otherHistograms = allHistograms(other);
+        for(std::size_t i = 0; i < histograms.size(); i++){
+            histograms[i]->merge(*otherHistograms[i]);
+        }
+        this->jetResponseSketch.merge(other.jetResponseSketch);
+        this->fsResponseSketch.merge(other.fsResponseSketch);
+        this->fsInJetResponseSketch.merge(other.fsInJetResponseSketch);
+        for(std::size_t i = 0; i < this->jetDarknessSketches.size(); i++){
+            this->jetDarknessSketches[i].merge(other.jetDarknessSketches[i]);
+        }
+        this->substructure.merge(other.substructure);
+        for(std::size_t i = 0; i < this->jetMultiplicityData.size(); i++){
+            for(const std::pair<const int, long> &multiplicityEvents: other.jetMultiplicityData[i]){
+                this->jetMultiplicityData[i][multiplicityEvents.first] += multiplicityEvents.second;
+            }
+        }
+    }
+
+    //Adds a single event, and with BOOTSTRAP_REPLICAS also its purity, efficiency and response to the bootstrap replicas, with weights that only depend on eventId.
+    //With WEIGHT_VARIATIONS, the purity, efficiency, response and the histograms of the event are also added with each of eventWeights, the generator weights of the event (see MultiWeight.hpp).
+    void addEvent(const DarkJetEventResult &event, std::uint64_t eventId, const std::vector<double> &eventWeights, const DarkJetOptions &options){
+        this->events++;
+        this->eventsWithoutResonance += event.withoutResonance;
+        this->eventsWithTooFewJets += event.withTooFewJets;
+        this->cutflow.merge(event.cutflow);
+        for(std::size_t i = 0; i < this->efficiencyData.size(); i++){
+            this->efficiencyData[i] += event.efficiencyData[i];
+        }
+        this->totalPT += event.totalPT;
+        this->purePT += event.purePT;
+        this->responseSum += event.responseSum;
+        this->numberOfEventsWithResponse += event.numberOfResponses;
+        if(options.weightVariations && this->weightedHistograms.empty()){
+            for(const Histogram *histogram: allHistograms(*this)){
+                this->weightedHistograms.push_back(WeightedHistogram(histogram->name(), histogram->bins(), histogram->min(), histogram->max(), eventWeights.size()));
+            }
+        }
+        //The indices are the positions in allHistograms
+        for(double value: event.partonPT){
+            this->fillHistogram(this->partonPT, 0, value, eventWeights, options);
+        }
+        for(double value: event.jetResponse){
+            this->fillHistogram(this->jetResponse, 1, value, eventWeights, options);
+        }
+        for(double value: event.fsResponse){
+            this->fillHistogram(this->fsResponse, 2, value, eventWeights, options);
+        }
+        for(double value: event.fsInJetResponse){
+            this->fillHistogram(this->fsInJetResponse, 3, value, eventWeights, options);
+        }
+        for(std::size_t i = 0; i < this->jetPT.size() && i < event.jetPT.size(); i++){
+            this->fillHistogram(this->jetPT[i], 4 + 3 * i, event.jetPT[i], eventWeights, options);
+            this->fillHistogram(this->jetInvisibility[i], 5 + 3 * i, event.jetInvisibility[i], eventWeights, options);
+            this->fillHistogram(this->jetDarkness[i], 6 + 3 * i, event.jetDarkness[i], eventWeights, options);
+            this->jetDarknessSketches[i].fill(event.jetDarkness[i]);
+        }
+        for(double response: event.allJetResponses){
+            this->jetResponseSketch.fill(response);
+        }
+        for(double response: event.allFsResponses){
+            this->fsResponseSketch.fill(response);
+        }
+        for(double response: event.allFsInJetResponses){
+            this->fsInJetResponseSketch.fill(response);
+        }
+        for(const JetSubstructure &substructure: event.substructures){
+            this->substructure.fill(substructure);
+        }
+        for(std::size_t i = 0; i < this->jetMultiplicityData.size() && i < event.jetMultiplicities.size(); i++){
+            this->jetMultiplicityData[i][event.jetMultiplicities[i]]++;
+        }
+        if(options.bootstrapReplicas > 0){
+            TIME_SCOPE("bootstrap");
+            const BootstrapWeights weights(options.bootstrapReplicas, eventId);
+            this->bootstrapPurity.fill(weights, event.purePT, event.totalPT);
+            this->bootstrapEfficiency.fill(weights, event.efficiencyData[efficiencyBin(options)], 1.0);
+            this->bootstrapResponse.fill(weights, event.responseSum, event.numberOfResponses);
+        }
+        if(options.weightVariations){
+            TIME_SCOPE("weight variations");
+            this->weightedPurity.fill(eventWeights, event.purePT, event.totalPT);
+            this->weightedEfficiency.fill(eventWeights, event.efficiencyData[efficiencyBin(options)], 1.0);
+            this->weightedResponse.fill(eventWeights, event.responseSum, event.numberOfResponses);
+        }
+    }
+
+    //Prints the same numbers as PartonTruthEfficiency::finalize
+    void print(const DarkJetOptions &options) const{
+        const double efficiencyScale = options.plotSecondChildren == 2 ? 25.0 : 50.0;
+        std::cout << "Purity: " << (100.0 * this->purePT / this->totalPT) << "%" << bootstrapUncertaintyText(this->bootstrapPurity, 100.0, "%") << std::endl;
+        std::cout << "Efficiency at DeltaR = R: " << (efficiencyScale * this->efficiencyData[efficiencyBin(options)] / this->events) << "%" << bootstrapUncertaintyText(this->bootstrapEfficiency, efficiencyScale, "%") << std::endl;
+        std::cout << "Average response: " << (this->responseSum / this->numberOfEventsWithResponse) << bootstrapUncertaintyText(this->bootstrapResponse) << std::endl;
+        std::cout << "JetResponse: " << quantileText(this->jetResponseSketch, options.percentiles) << std::endl;
+        std::cout << "FsResponse: " << quantileText(this->fsResponseSketch, options.percentiles) << std::endl;
+        std::cout << "FsInJetResponse: " << quantileText(this->fsInJetResponseSketch, options.percentiles) << std::endl;
+        for(std::size_t i = 0; i < this->jetDarkness.size(); i++){
+            std::cout << this->jetDarkness[i].name() << ": " << quantileText(this->jetDarknessSketches[i], options.percentiles, 1.0, "%") << std::endl;
+        }
+        if(options.substructure){
+            this->substructure.print(options.percentiles);
+        }
+        for(const Histogram &histogram: this->jetDarkness){
+            std::cout << "Average " << histogram.name() << ": " << histogram.mean() << "%" << std::endl;
+        }
+        const std::vector<std::string> labels{"Jets with pT > 100 GeV", "Dark jets with f_dark > 0.2", "Dark jets with f_dark > 0.5", "Dark jets with f_dark > 0.8"};
+        for(std::size_t i = 0; i < this->jetMultiplicityData.size(); i++){
+            std::cout << labels[i] << ":";
+            for(const std::pair<const int, long> &multiplicityEvents: this->jetMultiplicityData[i]){
+                std::cout << " " << multiplicityEvents.first << " in " << (100.0 * multiplicityEvents.second / this->events) << "%";
+            }
+            std::cout << std::endl;
+        }
+        if(this->eventsWithoutResonance > 0){
+            std::cout << "Resonance particle not found in " << this->eventsWithoutResonance << " events." << std::endl;
+        }
+        if(this->eventsWithTooFewJets > 0){
+            std::cout << "Skipped " << this->eventsWithTooFewJets << " events with too few jets." << std::endl;
+        }
+        options.preSelection.printCutflow(this->cutflow);
+    }
+
+    //Prints the purity, efficiency and average response for each weight, named by weightNames, like PartonTruthEfficiency does with WEIGHT_VARIATIONS
+    void printWeightVariations(const std::vector<std::string> &weightNames, const DarkJetOptions &options) const{
+        const double efficiencyScale = options.plotSecondChildren == 2 ? 25.0 : 50.0;
+        std::cout << std::endl << "Weight variations:" << std::endl;
+        for(std::size_t i = 0; i < this->weightedPurity.weights() && i < weightNames.size(); i++){
+            std::cout << weightNames[i] << ": purity " << (100.0 * this->weightedPurity.value(i)) << "%, efficiency at DeltaR = R " << (efficiencyScale * this->weightedEfficiency.value(i)) << "%, average response " << this->weightedResponse.value(i) << std::endl;
+        }
+    }
+
+    void write(std::ostream &stream) const{
+        stream << "histogram\tlow\thigh\tcontent" << std::endl;
+        for(const Histogram *histogram: allHistograms(*this)){
+            histogram->write(stream);
+        }
+    }
+
+    //Writes the histograms filled with each weight as a table with one column per weight
+    void writeWeightVariations(std::ostream &stream, const std::vector<std::string> &weightNames) const{
+        writeWeightedHistogramHeader(stream, weightNames);
+        for(const WeightedHistogram &histogram: this->weightedHistograms){
+            histogram.write(stream);
+        }
+    }
+
+    long events;    //All events, including the ones without a resonance, like Rivet's numEvents()
+    long eventsWithoutResonance;
+    long eventsWithTooFewJets;
+    Cutflow cutflow;    //Of the pre-selection in DarkJetOptions
+    std::vector<long> efficiencyData;
+    double totalPT, purePT;
+    double responseSum;
+    long numberOfEventsWithResponse;
+    Histogram partonPT, jetResponse, fsResponse, fsInJetResponse;
+    std::vector<Histogram> jetPT, jetInvisibility, jetDarkness;
+    QuantileSketch jetResponseSketch, fsResponseSketch, fsInJetResponseSketch;    //All responses, also the ones above maxResponse that the histograms leave out
+    std::vector<QuantileSketch> jetDarknessSketches;    //Darkness of the three leading jets in %
+    SubstructureSummary substructure;    //Of the three leading jets, only filled with SUBSTRUCTURE
+    std::vector<std::map<int, long>> jetMultiplicityData{4};    //All jets, and dark jets with darkness > 0.2, 0.5 and 0.8
+    BootstrapRatio bootstrapPurity, bootstrapEfficiency, bootstrapResponse;    //Only filled by addEvent with BOOTSTRAP_REPLICAS
+    WeightedRatio weightedPurity, weightedEfficiency, weightedResponse;    //Only filled by addEvent with WEIGHT_VARIATIONS
+    std::vector<WeightedHistogram> weightedHistograms;    //In the same order as allHistograms, only filled by addEvent with WEIGHT_VARIATIONS
+
+private:
+    //Fills histogram, and with WEIGHT_VARIATIONS also weightedHistograms[index]
+    void fillHistogram(Histogram &histogram, std::size_t index, double value, const std::vector<double> &eventWeights, const DarkJetOptions &options){
+        histogram.fill(value);
+        if(options.weightVariations){
+            this->weightedHistograms[index].fill(value, eventWeights);
+        }
+    }
+
+    //The bin of efficiencyData at DeltaR = R
+    static std::size_t efficiencyBin(const DarkJetOptions &options){
+        return (DarkJetOptions::deltaRBins + 1) * options.jetRadius / DarkJetOptions::deltaRMax;
+    }
+
+    //Pointers to all histograms of accumulator, which is either const or not
+    template<typename Accumulator> static std::vector<decltype(&std::declval<Accumulator&>().partonPT)> allHistograms(Accumulator &accumulator){
+        std::vector<decltype(&accumulator.partonPT)> histograms{&accumulator.partonPT, &accumulator.jetResponse, &accumulator.fsResponse, &accumulator.fsInJetResponse};
+        for(std::size_t i = 0; i < accumulator.jetPT.size(); i++){
+            histograms.push_back(&accumulator.jetPT[i]);
+            histograms.push_back(&accumulator.jetInvisibility[i]);
+            histograms.push_back(&accumulator.jetDarkness[i]);
+        }
+        return histograms;
+    }
+};
+
+//Same as Rivet::Particle::isVisible for the particles in the final state of the models: neutrinos and dark hadrons are invisible
+inline bool pdgIdIsVisible(int pdgid){
+    const int abspid = std::abs(pdgid);
+    return abspid != 12 && abspid != 14 && abspid != 16 && abspid / 100000 != 49 && abspid != 1000022 && abspid != 1000039;
+}
+
+inline fastjet::PseudoJet pseudoJet(const FlatParticle &particle){
+    fastjet::PseudoJet pseudoJet(particle.px(), particle.py(), particle.pz(), particle.energy());
+    pseudoJet.set_user_index(particle.index());
+    return pseudoJet;
+}
+
+//The constituents of a jet clustered from pseudoJet(particle), as handles into event
+inline std::vector<FlatParticle> jetParticles(const fastjet::PseudoJet &jet, const FlatEvent &event){
+    std::vector<FlatParticle> particles;
+    for(const fastjet::PseudoJet &constituent: jet.constituents()){
+        particles.push_back(event.particle(constituent.user_index()));
+    }
+    return particles;
+}
+
+//The event analyzeDarkJetEvent should run on: event itself, or with COMPACT_GENEALOGY its compacted genealogy, which is stored in compacted and gives the same results with shorter genealogy walks
+inline const FlatEvent& eventToAnalyze(const FlatEvent &event, const DarkJetOptions &options, FlatEventStorage &compacted){
+    if(!options.compactGenealogy){
+        return event;
+    }
+    compactGenealogy(event, particlesToKeep(event, options.resonancePdgIds), compacted);
+    return compacted.view();
+}
+
+//What analyzeDarkJetEvent reuses between events, so that its arrays are only allocated once. Keep one per thread, like the FlatEventStorage the events are converted to.
+struct DarkJetWorkspace{
+    explicit DarkJetWorkspace(const DarkJetOptions &options): substructureCalculator(options.jetRadius){}
+
+    FlatEventStorage overlaid;    //The event with the pile-up overlaid
+    SubstructureCalculator substructureCalculator;    //Only used with SUBSTRUCTURE
+};
+
+//The same as PartonTruthEfficiency::analyze without the event display. hardEvent should be in GeV, and can be a FlatEventStorage view or an event from an EventCacheReader. eventId chooses the pile-up events that are overlaid with PILEUP_MU.
+//result is cleared first, and can then be added to a DarkJetAccumulator with addEvent.
+inline void analyzeDarkJetEvent(const FlatEvent &hardEvent, const DarkJetOptions &options, DarkJetWorkspace &workspace, DarkJetEventResult &result, std::uint64_t eventId = 0){
+    TIME_SCOPE("analyze");
+    TIMING_COUNT("events", 1);
+    result.clear();
+
+    //Find the excited quark, and reject the event before clustering if it doesn't pass the pre-selection
+    FlatParticle excitedQuark;
+    {
+        TIME_SCOPE("pre-selection");
+        const std::size_t cutsPassed = options.preSelection.apply(hardEvent, result.cutflow, excitedQuark);
+        if(cutsPassed == 0){
+            result.withoutResonance = true;
+            TIMING_COUNT("events without resonance", 1);
+        }
+        if(cutsPassed < options.preSelection.cuts()){
+            return;
+        }
+    }
+
+    //Overlay the pile-up on the final state, after the pre-selection so that rejected events don't pay for it
+    if(options.pileUp){
+        overlayPileUp(hardEvent, *options.pileUp, eventId, workspace.overlaid);
+        excitedQuark = workspace.overlaid.particle(excitedQuark.index());
+    }
+    const FlatEvent &event = options.pileUp ? workspace.overlaid.view() : hardEvent;
+
+    //Cluster the final state with the same settings as the Rivet analysis (anti-kt, muons included, invisibles depending on INCLUDE_INVISIBLES)
+    const std::vector<FlatParticle> finalState = event.particlesWithStatus(1);
+    std::unique_ptr<const fastjet::ClusterSequence> clusterSequence;    //The constituents of the jets are only available while the cluster sequence exists
+    std::vector<fastjet::PseudoJet> jets;
+    {
+        TIME_SCOPE_PER_CALL("clustering");
+        std::vector<fastjet::PseudoJet> inputs;
+        for(const FlatParticle &particle: finalState){
+            if(options.includeInvisibles || pdgIdIsVisible(particle.pid())){
+                const fastjet::PseudoJet input = pseudoJet(particle);
+                if(particleIsClustered(input.eta(), options.clustering)){
+                    inputs.push_back(input);
+                }
+            }
+        }
+        TIMING_COUNT("clustered particles", inputs.size());
+        clusterSequence.reset(new fastjet::ClusterSequence(inputs, clusteringJetDefinition(fastjet::antikt_algorithm, options.jetRadius, options.clustering)));
+        jets = selectedJets(*clusterSequence, options.clustering);
+    }
+    const std::size_t numberOfLeadingJets = options.plotSecondChildren == 2 ? 4 : 2;
+    if(jets.size() < std::max(numberOfLeadingJets, DarkJetOptions::leadingJets)){
+        result.withTooFewJets = true;
+        return;
+    }
+
+    //Find the children of the particle
+    std::vector<FlatParticle> children, finalPartonLevelParticles;
+    for(std::size_t i = 0; i < excitedQuark.numberOfChildren(); i++){
+        FlatParticle child = excitedQuark.child(i);
+        children.push_back(child);
+        const double mass = std::sqrt(std::max(child.energy() * child.energy() - child.px() * child.px() - child.py() * child.py() - child.pz() * child.pz(), 0.0));
+        if(options.plotSecondChildren && (options.plotSecondChildren == 2 || mass > 50)){
+            while(child.numberOfChildren() == 1){
+                child = child.child(0);
+            }
+            for(std::size_t j = 0; j < child.numberOfChildren(); j++){
+                finalPartonLevelParticles.push_back(child.child(j));
+            }
+        }
+        else{
+            finalPartonLevelParticles.push_back(child);
+        }
+    }
+
+    //Count the efficiency and purity of the jets
+    std::vector<std::size_t> remainingLeadingJets;
+    for(std::size_t i = 0; i < numberOfLeadingJets; i++){
+        remainingLeadingJets.push_back(i);
+    }
+    std::vector<bool> inJet(event.size);
+    for(const FlatParticle &parton: options.plotSecondChildren == 2 ? finalPartonLevelParticles : children){
+        if(remainingLeadingJets.empty()){
+            break;
+        }
+        TIME_SCOPE("matching partons to jets");
+        const fastjet::PseudoJet partonMomentum = pseudoJet(parton);
+        double deltaR = 1e6;    //Start with something that's guaranteed to be much larger than the actual deltaR
+        std::vector<std::size_t>::iterator jetIterator = remainingLeadingJets.begin();
+        for(std::vector<std::size_t>::iterator newJet = remainingLeadingJets.begin(); newJet != remainingLeadingJets.end(); newJet++){
+            const double deltaY = partonMomentum.rap() - jets[*newJet].rap();
+            double deltaPhi = partonMomentum.phi() - jets[*newJet].phi();
+            if(deltaPhi < -M_PI) deltaPhi += 2 * M_PI;
+            else if(deltaPhi > M_PI) deltaPhi -= 2 * M_PI;
+            const double newDeltaR = std::sqrt(deltaY * deltaY + deltaPhi * deltaPhi);
+            if(newDeltaR < deltaR){
+                deltaR = newDeltaR;
+                jetIterator = newJet;
+            }
+        }
+        const fastjet::PseudoJet &jet = jets[*jetIterator];
+        remainingLeadingJets.erase(jetIterator);
+
+        //Efficiency
+        for(int i = deltaR * DarkJetOptions::deltaRBins / DarkJetOptions::deltaRMax; i < DarkJetOptions::deltaRBins + 1; i++){
+            result.efficiencyData[i]++;
+        }
+
+        //Purity
+        std::fill(inJet.begin(), inJet.end(), false);
+        const std::vector<FlatParticle> constituents = jetParticles(jet, event);
+        TIMING_RECORD("matched jet constituents", constituents.size());
+        for(const FlatParticle &particle: constituents){
+            inJet[particle.index()] = true;
+            const double pT = std::hypot(particle.px(), particle.py());
+            if(particleIsFromParton(particle, parton)){
+                result.purePT += pT;
+            }
+            result.totalPT += pT;
+        }
+
+        //Response
+        const double partonPT = partonMomentum.pt();
+        if(partonPT < DarkJetOptions::maxPT){
+            result.partonPT.push_back(partonPT);
+        }
+        double fsPT = 0.0, fsInJetPT = 0.0;
+        for(const FlatParticle &particle: finalState){
+            if(particleIsFromParton(particle, parton)){
+                const double pT = std::hypot(particle.px(), particle.py());
+                fsPT += pT;
+                if(inJet[particle.index()]){
+                    fsInJetPT += pT;
+                }
+            }
+        }
+        if(deltaR <= options.jetRadius){
+            result.allJetResponses.push_back(jet.pt() / partonPT);
+            if(fsInJetPT > 0){
+                result.allFsInJetResponses.push_back(fsInJetPT / partonPT);
+            }
+            if(jet.pt() < partonPT * DarkJetOptions::maxResponse){
+                result.jetResponse.push_back(jet.pt() / partonPT);
+                result.responseSum += jet.pt() / partonPT;
+                result.numberOfResponses++;
+            }
+            if(fsInJetPT < partonPT * DarkJetOptions::maxResponse && fsInJetPT > 0){
+                result.fsInJetResponse.push_back(fsInJetPT / partonPT);
+            }
+        }
+        if(fsPT > 0){
+            result.allFsResponses.push_back(fsPT / partonPT);
+        }
+        if(fsPT < partonPT * DarkJetOptions::maxResponse && fsPT > 0){
+            result.fsResponse.push_back(fsPT / partonPT);
+        }
+    }
+
+    //Jet pT, invisibility, darkness and substructure
+    TIME_SCOPE("jet darkness");
+    for(std::size_t i = 0; i < DarkJetOptions::leadingJets; i++){
+        const std::vector<FlatParticle> constituents = jetParticles(jets[i], event);
+        TIMING_RECORD("three leading jets constituents", constituents.size());
+        double invisiblePx = 0.0, invisiblePy = 0.0;
+        for(const FlatParticle &particle: constituents){
+            if(!pdgIdIsVisible(particle.pid())){
+                invisiblePx += particle.px();
+                invisiblePy += particle.py();
+            }
+        }
+        result.jetPT.push_back(jets[i].pt());
+        const double invisibility = std::min(std::hypot(invisiblePx, invisiblePy) / jets[i].pt(), 1.0);
+        result.jetInvisibility.push_back(invisibility * 100.0);
+        const double darkness = pTDarkness(constituents) * 100.0;
+        result.jetDarkness.push_back(darkness);
+        if(options.substructure){
+            JetSubstructure substructure = workspace.substructureCalculator.compute(jets[i]);
+            substructure.pTDarkness = darkness / 100.0;    //The standalone pipeline finds the darkness from the constituents instead of a JetComposition
+            substructure.pTInvisibility = invisibility;
+            result.substructures.push_back(substructure);
+        }
+    }
+
+    //Jet multiplicity
+    std::vector<int> &multiplicities = result.jetMultiplicities;
+    multiplicities.assign(4, 0);
+    for(const fastjet::PseudoJet &jet: jets){
+        if(jet.pt() < 100){
+            break;
+        }
+        const double darkness = pTDarkness(jetParticles(jet, event));
+        multiplicities[0]++;
+        multiplicities[1] += darkness > 0.2;
+        multiplicities[2] += darkness > 0.5;
+        multiplicities[3] += darkness > 0.8;
+    }
+}
\ No newline at end of file
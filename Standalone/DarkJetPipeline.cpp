@@ -0,0 +1,222 @@
+#include <HepMC3/GenEvent.h>
+#include <HepMC3/ReaderFactory.h>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include "BoundedQueue.hpp"
+#include "DarkJetAnalysis.hpp"
+#include "../Headers/ParticleHandle.hpp"
+#include "../Headers/EventCache.hpp"
+#include "../Headers/Timing.hpp"
+#include "../Headers/Telemetry.hpp"
+
+//Reader thread -> bounded queue -> worker threads (clustering, tagging and matching) -> bounded queue -> merging in event order on the main thread
+//For an event cache there is no reader thread, the workers take the next event number from a counter and read the event directly from the memory-mapped file
+int main(int argc, char **argv){
+    std::string infile, outfile = "DarkJetPipeline.tsv", weightsFile = "DarkJetPipelineWeights.tsv";
+    int jobs = std::max(1u, std::thread::hardware_concurrency());
+    long maxEvents = -1;
+
+    for(int argi = 1; argi < argc; argi++){
+        const std::string arg = argv[argi];
+        if(arg == "-o" || arg == "--output"){
+            outfile = argv[++argi];
+        }
+        else if(arg == "-w" || arg == "--weights"){
+            weightsFile = argv[++argi];
+        }
+        else if(arg == "-j" || arg == "--jobs"){
+            jobs = std::max(1, std::atoi(argv[++argi]));
+        }
+        else if(arg == "-n" || arg == "--events"){
+            maxEvents = std::atol(argv[++argi]);
+        }
+        else if(arg == "-h" || arg == "--help"){
+            std::cout << "Usage: DarkJetPipeline [options] infile" << std::endl
+                << "infile can be a HepMC file or an event cache made by ConvertToEventCache." << std::endl
+                << "Options:" << std::endl
+                << "  -h, --help:           Show this help text and exit" << std::endl
+                << "  -o, --output <path>:  Specifies which file the histograms should be written to, defaults to DarkJetPipeline.tsv" << std::endl
+                << "  -w, --weights <path>: With WEIGHT_VARIATIONS=1, the file the histograms for all weights are written to, defaults to DarkJetPipelineWeights.tsv" << std::endl
+                << "  -j, --jobs <n>:       Number of worker threads, defaults to the number of cores" << std::endl
+                << "  -n, --events <n>:     Only analyze the first <n> events" << std::endl
+                << "The analysis options are the same environment variables as for the PartonTruthEfficiency Rivet analysis: JET_RADIUS, INCLUDE_INVISIBLES, PLOT_SECOND_CHILDREN, RES_PDGID, DARK_REGEX, COMPACT_GENEALOGY, BOOTSTRAP_REPLICAS, WEIGHT_VARIATIONS, MIN_JET_PT, MAX_PARTICLE_ETA, MAX_JET_ETA, MAX_JETS, CLUSTERING_STRATEGY, PERCENTILES, PRESELECT_DECAY, PRESELECT_MIN_PARTON_PT, PRESELECT_MIN_MULTIPLICITY, PILEUP_FILE, PILEUP_MU and SUBSTRUCTURE." << std::endl;
+            return 0;
+        }
+        else if(infile == ""){
+            infile = arg;
+        }
+        else{
+            std::cerr << "Cannot interpret argument: " << argv[argi] << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if(infile == ""){
+        std::cerr << "No input file specified. Needs to be given as argument." << std::endl;
+        return EXIT_FAILURE;
+    }
+    EventCacheReader cache;
+    std::shared_ptr<HepMC3::Reader> reader;
+    if(fileIsEventCache(infile)){
+        if(!cache.open(infile)){
+            return EXIT_FAILURE;
+        }
+        cache.willReadAll();
+    }
+    else{
+        reader = HepMC3::deduce_reader(infile);
+        if(!reader || reader->failed()){
+            std::cerr << "Could not read " << infile << "." << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    const DarkJetOptions options;
+    pdgIdIsDark(0);    //Read DARK_REGEX before starting the threads
+    const long numberOfCachedEvents = maxEvents < 0 ? cache.size() : std::min<long>(maxEvents, cache.size());
+    Telemetry telemetry("DarkJetPipeline", cache.isOpen() ? numberOfCachedEvents : maxEvents);    //Updated by the main thread as the results are merged
+    const auto start = std::chrono::steady_clock::now();
+
+    typedef std::pair<long, std::unique_ptr<HepMC3::GenEvent>> NumberedEvent;
+    //The result of an event with its weights, which are only needed with WEIGHT_VARIATIONS
+    struct EventResult{
+        DarkJetEventResult result;
+        std::vector<double> weights;
+    };
+    //The results are kept in a fixed number of slots, which bounds how many events can wait to be merged behind a slow one.
+    //A worker takes a free slot before it takes an event, and the main thread frees the slot again once it has merged the event.
+    const std::size_t window = 4 * jobs;
+    std::vector<EventResult> slots(window);
+    BoundedQueue<std::size_t> freeSlots(window);
+    for(std::size_t slot = 0; slot < window; slot++){
+        freeSlots.push(slot);
+    }
+    typedef std::pair<long, std::size_t> NumberedResult;    //The event number and the slot with its result
+    std::vector<std::string> weightNames;    //Set by the reader thread from the first event
+    BoundedQueue<NumberedEvent> events(4 * jobs);
+    BoundedQueue<NumberedResult> results(window);
+
+    std::thread readerThread([&]{
+        if(cache.isOpen()){
+            events.close();    //Nothing to read, the workers read the cache directly
+            return;
+        }
+        for(long number = 0; maxEvents < 0 || number < maxEvents; number++){
+            std::unique_ptr<HepMC3::GenEvent> event(new HepMC3::GenEvent());
+            {
+                TIME_SCOPE("reading HepMC");
+                reader->read_event(*event);
+            }
+            if(reader->failed()){
+                break;
+            }
+            if(number == 0){
+                weightNames = eventWeightNames(*event);
+            }
+            if(!events.push(NumberedEvent(number, std::move(event)))){
+                break;
+            }
+        }
+        events.close();
+    });
+
+    std::vector<std::thread> workers;
+    int runningWorkers = jobs;
+    std::mutex runningWorkersMutex;
+    std::atomic<long> nextCachedEvent(0);
+    for(int job = 0; job < jobs; job++){
+        workers.push_back(std::thread([&]{
+            FlatEventStorage compacted;    //Reused between events like flatEvent below
+            DarkJetWorkspace workspace(options);
+            std::size_t slot;
+            while(freeSlots.pop(slot)){
+                const long number = nextCachedEvent++;
+                if(number >= numberOfCachedEvents){
+                    freeSlots.push(slot);
+                    break;
+                }
+                const FlatEvent event = cache.event(number);
+                analyzeDarkJetEvent(eventToAnalyze(event, options, compacted), options, workspace, slots[slot].result, number);
+                if(options.weightVariations){
+                    slots[slot].weights = eventWeights(event);
+                }
+                results.push(NumberedResult(number, slot));
+            }
+            FlatEventStorage flatEvent;    //Reused between events so that its arrays are only allocated once per thread
+            NumberedEvent event;
+            while(freeSlots.pop(slot)){
+                if(!events.pop(event)){
+                    freeSlots.push(slot);
+                    break;
+                }
+                {
+                    TIME_SCOPE("converting to a flat event");
+                    event.second->set_units(HepMC3::Units::GEV, HepMC3::Units::MM);
+                    flatEvent.fill(*event.second);
+                    event.second.reset();
+                }
+                analyzeDarkJetEvent(eventToAnalyze(flatEvent.view(), options, compacted), options, workspace, slots[slot].result, event.first);
+                if(options.weightVariations){
+                    slots[slot].weights = eventWeights(flatEvent.view());
+                }
+                results.push(NumberedResult(event.first, slot));
+            }
+            std::lock_guard<std::mutex> lock(runningWorkersMutex);
+            if(--runningWorkers == 0){
+                results.close();
+            }
+        }));
+    }
+
+    //Merge the results in event order, so that the sums are done in the same order for any number of threads
+    //The events that are taken but not merged yet each hold a slot, so they are less than window events after nextEvent, and event number % window tells where each of them waits
+    DarkJetAccumulator total;
+    std::vector<long> pendingSlots(window, -1);
+    long nextEvent = 0;
+    NumberedResult result;
+    while(results.pop(result)){
+        pendingSlots[result.first % window] = result.second;
+        while(pendingSlots[nextEvent % window] >= 0){
+            long &slot = pendingSlots[nextEvent % window];
+            const EventResult &eventResult = slots[slot];
+            total.addEvent(eventResult.result, nextEvent, eventResult.weights, options);
+            telemetry.count("events without resonance", eventResult.result.withoutResonance);
+            telemetry.count("events with too few jets", eventResult.result.withTooFewJets);
+            telemetry.event();
+            freeSlots.push(slot);
+            slot = -1;
+            nextEvent++;
+        }
+    }
+    readerThread.join();
+    for(std::thread &worker: workers){
+        worker.join();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << std::endl << "Analyzed " << total.events << " events in " << seconds << " s (" << total.events / seconds << " events/s) with " << jobs << " worker threads." << std::endl << std::endl;
+    total.print(options);
+    TIMING_WRITE_SUMMARY("DarkJetPipeline");
+    telemetry.finish();
+    std::ofstream file(outfile);
+    total.write(file);
+    std::cout << "Histograms written to " << outfile << std::endl;
+    if(options.weightVariations){
+        if(cache.isOpen()){
+            weightNames = defaultWeightNames(cache.size() > 0 ? cache.event(0).numberOfWeights : 0);    //The cache doesn't store the names of the weights
+        }
+        total.printWeightVariations(weightNames, options);
+        std::ofstream weights(weightsFile);
+        total.writeWeightVariations(weights, weightNames);
+        std::cout << "Histograms for all weights written to " << weightsFile << std::endl;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,249 @@
+#include <Pythia8/Pythia.h>
+#include <Pythia8Plugins/HepMC3.h>
+#include <HepMC3/GenEvent.h>
+#include <HepMC3/WriterAscii.h>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdint>
+#include "DarkJetAnalysis.hpp"
+#include "../Headers/ParticleHandle.hpp"
+#include "../Headers/Timing.hpp"
+#include "../Headers/Telemetry.hpp"
+
+//Everything one seed produces, filled by its own thread and merged in the order of the seeds at the end
+struct SeedResult{
+    int seed = 0;
+    long events = 0;
+    long failedEvents = 0;
+    double crossSection = 0.0;    //In mb, as estimated by Pythia at the end of the run
+    bool initialized = false;
+    DarkJetAccumulator accumulator;
+    std::vector<std::string> weightNames;    //From the first event
+};
+
+//Generates events with the Pythia card with Random:seed = seed and analyzes each event right after it is generated, without writing it anywhere (unless hepmcPath isn't empty)
+static void runSeed(const std::string &card, int seed, long events, bool quiet, const std::string &hepmcPath, const DarkJetOptions &options, SeedResult &result, std::atomic<long> &generatedEvents){
+    result.seed = seed;
+    Pythia8::Pythia pythia("../share/Pythia8/xmldoc", false);    //PYTHIA8DATA overrides the path to the xmldoc folder
+    if(!pythia.readFile(card)){
+        std::cerr << "Could not read the Pythia card " << card << "." << std::endl;
+        return;
+    }
+    pythia.readString("Random:setSeed = on");
+    pythia.readString("Random:seed = " + std::to_string(seed));
+    if(quiet){
+        pythia.readString("Print:quiet = on");    //Only the first seed prints the initialization and the first events
+    }
+    if(!pythia.init()){
+        std::cerr << "Pythia could not be initialized with seed " << seed << "." << std::endl;
+        return;
+    }
+    result.initialized = true;
+    const long timesAllowErrors = pythia.mode("Main:timesAllowErrors");
+
+    HepMC3::Pythia8ToHepMC3 toHepMC;
+    std::unique_ptr<HepMC3::WriterAscii> writer;
+    if(hepmcPath != ""){
+        writer.reset(new HepMC3::WriterAscii(hepmcPath));
+    }
+    FlatEventStorage flatEvent, compacted;    //Reused between events so that their arrays are only allocated once per thread
+    DarkJetWorkspace workspace(options);
+    DarkJetEventResult eventResult;    //Also reused, and added to the accumulator of the seed right away
+    for(long number = 0; number < events; number++){
+        {
+            TIME_SCOPE("generating events");
+            if(!pythia.next()){
+                if(++result.failedEvents > timesAllowErrors){
+                    std::cerr << "Stopping seed " << seed << " after " << result.failedEvents << " failed events." << std::endl;
+                    break;
+                }
+                number--;
+                continue;
+            }
+        }
+        HepMC3::GenEvent event(HepMC3::Units::GEV, HepMC3::Units::MM);
+        {
+            TIME_SCOPE("converting to a flat event");
+            toHepMC.fill_next_event(pythia, &event, number);
+            event.set_units(HepMC3::Units::GEV, HepMC3::Units::MM);
+            flatEvent.fill(event);
+        }
+        if(writer){
+            TIME_SCOPE("writing HepMC");
+            writer->write_event(event);
+        }
+        if(result.events == 0){
+            result.weightNames = eventWeightNames(event);
+        }
+        const std::uint64_t eventId = (static_cast<std::uint64_t>(seed) << 32) + number;
+        analyzeDarkJetEvent(eventToAnalyze(flatEvent.view(), options, compacted), options, workspace, eventResult, eventId);
+        result.accumulator.addEvent(eventResult, eventId, options.weightVariations ? eventWeights(event) : std::vector<double>(), options);    //The events of each seed get their own bootstrap weights
+        result.events++;
+        generatedEvents++;
+    }
+    if(writer){
+        writer->close();
+    }
+    result.crossSection = pythia.info.sigmaGen();
+}
+
+//One thread per seed, each generating its events with Pythia and analyzing them itself. The accumulators of the seeds are merged in the order of the seeds, so the result only depends on the seeds and not on the timing of the threads.
+int main(int argc, char **argv){
+    std::string card, outfile = "PythiaPipeline.tsv", weightsFile = "PythiaPipelineWeights.tsv", hepmcPrefix;
+    int seeds = std::max(1u, std::thread::hardware_concurrency());
+    int firstSeed = 0;    //0 until it is given or read from the card
+    long totalEvents = -1;
+
+    for(int argi = 1; argi < argc; argi++){
+        const std::string arg = argv[argi];
+        if(arg == "-o" || arg == "--output"){
+            outfile = argv[++argi];
+        }
+        else if(arg == "-w" || arg == "--weights"){
+            weightsFile = argv[++argi];
+        }
+        else if(arg == "-j" || arg == "--seeds"){
+            seeds = std::max(1, std::atoi(argv[++argi]));
+        }
+        else if(arg == "-s" || arg == "--first-seed"){
+            firstSeed = std::atoi(argv[++argi]);
+            if(firstSeed < 1){
+                std::cerr << "The first seed must be at least 1, since Pythia takes the seed from the time for Random:seed = 0 and uses its default seed for negative ones." << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if(arg == "-n" || arg == "--events"){
+            totalEvents = std::atol(argv[++argi]);
+        }
+        else if(arg == "--hepmc"){
+            hepmcPrefix = argv[++argi];
+        }
+        else if(arg == "-h" || arg == "--help"){
+            std::cout << "Usage: PythiaPipeline [options] card" << std::endl
+                << "card is a Pythia card (.cmnd file), for example one of the cards in Example models." << std::endl
+                << "Options:" << std::endl
+                << "  -h, --help:             Show this help text and exit" << std::endl
+                << "  -o, --output <path>:    Specifies which file the histograms should be written to, defaults to PythiaPipeline.tsv" << std::endl
+                << "  -w, --weights <path>:   With WEIGHT_VARIATIONS=1, the file the histograms for all weights are written to, defaults to PythiaPipelineWeights.tsv" << std::endl
+                << "  -j, --seeds <n>:        Number of seeds, each generated on its own thread, defaults to the number of cores" << std::endl
+                << "  -s, --first-seed <s>:   The seeds are s, s + 1, ..., at least 1, defaults to Random:seed of the card, or 1 if that is below 1" << std::endl
+                << "  -n, --events <n>:       Total number of events over all seeds, defaults to Main:numberOfEvents of the card" << std::endl
+                << "  --hepmc <prefix>:       Also write the events of each seed to <prefix>.seed<s>.hepmc" << std::endl
+                << "The analysis options are the same environment variables as for the PartonTruthEfficiency Rivet analysis: JET_RADIUS, INCLUDE_INVISIBLES, PLOT_SECOND_CHILDREN, RES_PDGID, DARK_REGEX, COMPACT_GENEALOGY, BOOTSTRAP_REPLICAS, WEIGHT_VARIATIONS, MIN_JET_PT, MAX_PARTICLE_ETA, MAX_JET_ETA, MAX_JETS, CLUSTERING_STRATEGY, PERCENTILES, PRESELECT_DECAY, PRESELECT_MIN_PARTON_PT, PRESELECT_MIN_MULTIPLICITY, PILEUP_FILE, PILEUP_MU and SUBSTRUCTURE." << std::endl;
+            return 0;
+        }
+        else if(card == ""){
+            card = arg;
+        }
+        else{
+            std::cerr << "Cannot interpret argument: " << argv[argi] << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if(card == ""){
+        std::cerr << "No Pythia card specified. Needs to be given as argument." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    //Read the defaults from the card without initializing Pythia
+    {
+        Pythia8::Pythia pythia("../share/Pythia8/xmldoc", false);
+        if(!pythia.readFile(card)){
+            std::cerr << "Could not read the Pythia card " << card << "." << std::endl;
+            return EXIT_FAILURE;
+        }
+        if(totalEvents < 0){
+            totalEvents = pythia.mode("Main:numberOfEvents");
+        }
+        if(firstSeed == 0){
+            firstSeed = pythia.mode("Random:seed");
+            if(firstSeed < 1){    //Pythia would take the seed from the time, or use the same default seed for all threads, so the result couldn't be reproduced
+                std::cout << "Random:seed = " << firstSeed << " in " << card << " doesn't give reproducible seeds, so the first seed is 1." << std::endl;
+                firstSeed = 1;
+            }
+        }
+    }
+
+    const DarkJetOptions options;
+    pdgIdIsDark(0);    //Read DARK_REGEX before starting the threads
+    Telemetry telemetry("PythiaPipeline", totalEvents);    //Updated by the main thread from the number of events the seeds have generated
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<SeedResult> results(seeds);
+    std::atomic<long> generatedEvents(0);
+    std::atomic<int> runningSeeds(seeds);
+    std::vector<std::thread> threads;
+    for(int i = 0; i < seeds; i++){
+        const int seed = firstSeed + i;
+        const long events = totalEvents / seeds + (i < totalEvents % seeds ? 1 : 0);
+        const std::string hepmcPath = hepmcPrefix == "" ? "" : hepmcPrefix + ".seed" + std::to_string(seed) + ".hepmc";
+        threads.push_back(std::thread([&, i, seed, events, hepmcPath]{
+            runSeed(card, seed, events, i > 0, hepmcPath, options, results[i], generatedEvents);
+            runningSeeds--;
+        }));
+    }
+    long reportedEvents = 0;
+    while(runningSeeds > 0){
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        const long events = generatedEvents;
+        telemetry.event(events - reportedEvents);
+        reportedEvents = events;
+    }
+    for(std::thread &thread: threads){
+        thread.join();
+    }
+    telemetry.event(generatedEvents - reportedEvents);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    //Merge the seeds in order
+    DarkJetAccumulator total;
+    double crossSection = 0.0;
+    long failedEvents = 0;
+    int initializedSeeds = 0;
+    std::vector<std::string> weightNames;
+    for(const SeedResult &result: results){
+        if(!result.initialized){
+            continue;
+        }
+        if(weightNames.empty()){
+            weightNames = result.weightNames;
+        }
+        total.merge(result.accumulator);
+        crossSection += result.crossSection * result.events;
+        failedEvents += result.failedEvents;
+        initializedSeeds++;
+    }
+    if(initializedSeeds == 0){
+        return EXIT_FAILURE;
+    }
+
+    std::cout << std::endl << "Generated and analyzed " << total.events << " events in " << seconds << " s (" << total.events / seconds << " events/s) with " << initializedSeeds << " seeds from " << firstSeed << "." << std::endl;
+    if(failedEvents > 0){
+        std::cout << "Pythia failed to generate " << failedEvents << " events." << std::endl;
+    }
+    if(total.events > 0){
+        std::cout << "Cross section: " << crossSection / total.events << " mb" << std::endl;
+    }
+    std::cout << std::endl;
+    total.print(options);
+    TIMING_WRITE_SUMMARY("PythiaPipeline");
+    telemetry.finish();
+    std::ofstream file(outfile);
+    total.write(file);
+    std::cout << "Histograms written to " << outfile << std::endl;
+    if(options.weightVariations){
+        total.printWeightVariations(weightNames, options);
+        std::ofstream weights(weightsFile);
+        total.writeWeightVariations(weights, weightNames);
+        std::cout << "Histograms for all weights written to " << weightsFile << std::endl;
+    }
+    return 0;
+}
\ No newline at end of file